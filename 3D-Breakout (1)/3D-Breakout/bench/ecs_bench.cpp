@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "collision.h"
+#include "components.h"
+#include "registry.h"
+
+// Registry (sparse sets) contra objectos no heap com uma flag destroyed, como eram os
+// tijolos antes: criar, copiar os vivos para o snapshot de render, destruir metade ao acaso,
+// copiar outra vez e a fase larga das colisoes
+// Uso: ecs_bench [entidades]
+
+namespace {
+
+struct HeapBrick {
+    glm::vec3 position;
+    glm::vec3 size;
+    glm::vec3 color;
+    bool destroyed;
+};
+
+struct Instance {
+    glm::vec3 position;
+    glm::vec3 size;
+    glm::vec3 color;
+};
+
+double millis(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Fn>
+double measure(int repetitions, Fn fn) {
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) fn();
+    return millis(start) / repetitions;
+}
+
+glm::vec3 cellPosition(size_t i, size_t cols, size_t rows) {
+    return glm::vec3(-14.5f + 29.0f * (i % cols + 0.5f) / cols, 8.5f - 6.5f * (i / cols + 0.5f) / rows, 0.0f);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)std::atoi(argv[1]) : 100000;
+    size_t cols = 1000, rows = (count + cols - 1) / cols;
+    glm::vec3 size(0.02f, 0.005f, 1.0f);
+
+    // Ordem aleatoria (fixa) para destruir metade: o caso que desalinha os arrays densos
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+    std::vector<Instance> instances;
+    instances.reserve(count);
+
+    // ---- objectos no heap
+    std::vector<HeapBrick*> heap;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) heap.push_back(new HeapBrick{ cellPosition(i, cols, rows), size, glm::vec3(1.0f), false });
+    double heapCreate = millis(start);
+
+    auto heapSnapshot = [&] {
+        instances.clear();
+        for (const HeapBrick* b : heap) {
+            if (!b->destroyed) instances.push_back(Instance{ b->position, b->size, b->color });
+        }
+    };
+    double heapIterate = measure(20, heapSnapshot);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count / 2; i++) heap[order[i]]->destroyed = true;
+    double heapDestroy = millis(start);
+    double heapIterateHalf = measure(20, heapSnapshot);
+    for (HeapBrick* b : heap) delete b;
+
+    // ---- registry
+    Registry world;
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    start = std::chrono::steady_clock::now();
+    world.pool<Transform>().reserve(count);
+    world.pool<Tint>().reserve(count);
+    world.pool<Breakable>().reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        Entity e = world.create();
+        world.add(e, Transform{ cellPosition(i, cols, rows), size });
+        world.add(e, Tint{ glm::vec3(1.0f) });
+        world.add(e, Breakable{});
+        entities.push_back(e);
+    }
+    double worldCreate = millis(start);
+
+    auto worldSnapshot = [&] {
+        instances.clear();
+        world.each<Transform, Tint>([&](Entity, const Transform& t, const Tint& tint) {
+            instances.push_back(Instance{ t.position, t.size, tint.color });
+        });
+    };
+    double worldIterate = measure(20, worldSnapshot);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count / 2; i++) world.destroy(entities[order[i]]);
+    double worldDestroy = millis(start);
+    double worldIterateHalf = measure(20, worldSnapshot);
+
+    // Bola abaixo do campo: a fase larga percorre tudo sem destruir nada
+    Paddle paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
+    JobSystem serial(0);
+    double collision = measure(20, [&] {
+        Ball ball(glm::vec3(0.0f, -5.0f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+        Collision::resolve(ball, paddle, world, 12.0f, serial);
+    });
+
+    std::printf("entities: %zu (%zu alive after destroy)\n", count, world.size());
+    std::printf("%-28s %12s %12s %9s\n", "ms", "heap objects", "registry", "speedup");
+    auto row = [](const char* name, double heapMs, double worldMs) {
+        std::printf("%-28s %12.3f %12.3f %8.2fx\n", name, heapMs, worldMs, heapMs / worldMs);
+    };
+    row("create", heapCreate, worldCreate);
+    row("snapshot (all alive)", heapIterate, worldIterate);
+    row("destroy half (random)", heapDestroy, worldDestroy);
+    row("snapshot (half alive)", heapIterateHalf, worldIterateHalf);
+    std::printf("%-28s %12s %12.3f\n", "collision broad phase", "-", collision);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "collision.h"
+#include "geometry.h"
+#include "jobs.h"
+
+// Escalabilidade do JobSystem com 1-16 threads: custo por job, fase larga das colisoes
+// num campo grande de tijolos e matrizes model por tijolo (o trabalho tipico de culling)
+// Uso: job_scaling_bench [tijolos]
+
+namespace {
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Media de varias repeticoes depois de uma de aquecimento (acorda os workers)
+template <typename Fn>
+double measure(int repetitions, Fn fn) {
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) fn();
+    return seconds(start) / repetitions;
+}
+
+// Jobs vazios submetidos um a um: so o custo do deque, do roubo e do contador
+double emptyJobs(JobSystem& pool, std::vector<Job>& storage) {
+    return measure(20, [&] {
+        JobCounter counter;
+        for (auto& job : storage) {
+            job.fn = [](void*, size_t, size_t) {};
+            job.data = nullptr;
+            job.begin = job.end = 0;
+            pool.run(job, counter);
+        }
+        pool.wait(counter);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t brickCount = argc > 1 ? (size_t)std::atoi(argv[1]) : 1000000;
+
+    // Tijolos numa grelha densa no plano do tabuleiro, como no micro_bench
+    Registry world;
+    size_t cols = 1000, rows = (brickCount + cols - 1) / cols;
+    for (size_t i = 0; i < brickCount; i++) {
+        glm::vec3 pos(-14.5f + 29.0f * (i % cols + 0.5f) / cols, 8.5f - 6.5f * (i / cols + 0.5f) / rows, 0.0f);
+        Entity e = world.create();
+        world.add(e, Transform{ pos, glm::vec3(0.02f, 0.005f, 1.0f) });
+        world.add(e, Breakable{});
+    }
+    const Transform* transforms = world.pool<Transform>().data();
+    Paddle paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
+    std::vector<glm::mat4> models(brickCount);
+    glm::mat4 base = glm::scale(glm::mat4(1.0f), glm::vec3(0.0139f));
+    std::vector<Job> storage(JobDeque::CAPACITY / 2);
+
+    std::printf("hardware threads: %u, bricks: %zu\n", std::thread::hardware_concurrency(), brickCount);
+    std::printf("%-8s %14s %14s %9s %14s %9s\n", "threads", "empty job ns", "collision ms", "speedup", "matrices ms", "speedup");
+    double collisionBase = 0.0, matricesBase = 0.0;
+    for (unsigned threads = 1; threads <= 16; threads *= 2) {
+        JobSystem pool(threads - 1);
+
+        double perJob = emptyJobs(pool, storage) / storage.size();
+
+        // Bola abaixo do campo: a fase larga percorre todos os tijolos sem destruir nenhum
+        double collision = measure(20, [&] {
+            Ball ball(glm::vec3(0.0f, -5.0f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+            Collision::resolve(ball, paddle, world, 12.0f, pool);
+        });
+
+        double matrices = measure(10, [&] {
+            pool.parallelFor(brickCount, 4096, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) models[i] = Geometry::boardModelMatrix(base, transforms[i].position, transforms[i].size);
+            });
+        });
+
+        if (threads == 1) { collisionBase = collision; matricesBase = matrices; }
+        std::printf("%-8u %14.1f %14.3f %8.2fx %14.3f %8.2fx\n", threads, perJob * 1e9, collision * 1e3, collisionBase / collision,
+                    matrices * 1e3, matricesBase / matrices);
+    }
+
+    return 0;
+}
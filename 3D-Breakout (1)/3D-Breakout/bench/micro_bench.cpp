@@ -0,0 +1,226 @@
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "microbench.h"
+#include "collision.h"
+#include "geometry.h"
+#include "frustum.h"
+
+#ifdef MICROBENCH_MODEL3D
+#include "Model3D.hpp"
+#endif
+
+// Microbenchmarks das funcoes quentes do jogo (colisoes, matrizes dos tijolos, geometria, modelo)
+// Uso: micro_bench [--filter substr] [--json micro_bench.json] [--min-time s] [--repetitions n]
+// Corre na pasta do projecto: os benchmarks do Model3D leem o OBJ do arcade
+
+using microbench::State;
+using microbench::doNotOptimize;
+
+namespace {
+
+// Mesmos valores que o Game usa no tabuleiro
+const float BOARD_LEFT = -14.5f, BOARD_RIGHT = 14.5f;
+const float BRICKS_BOTTOM = 2.0f, BRICKS_TOP = 8.5f;
+const float BOUNCE_SPEED = 12.0f;
+
+// Grelha de n tijolos no registry, com os mesmos componentes do Game::createBricks
+struct BrickField {
+    Registry world;
+    std::vector<Entity> bricks;
+
+    explicit BrickField(size_t n) {
+        size_t cols = 10, rows = 5;
+        while (cols * rows < n) { cols *= 2; rows *= 2; }
+        float cellW = (BOARD_RIGHT - BOARD_LEFT) / cols, cellH = (BRICKS_TOP - BRICKS_BOTTOM) / rows;
+        bricks.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            size_t x = i % cols, y = i / cols;
+            glm::vec3 pos(BOARD_LEFT + (x + 0.5f) * cellW, BRICKS_TOP - (y + 0.5f) * cellH, 0.0f);
+            Entity e = world.create();
+            world.add(e, Transform{ pos, glm::vec3(cellW * 0.8f, cellH * 0.8f, 1.0f) });
+            world.add(e, Tint{ glm::vec3(1.0f) });
+            world.add(e, Breakable{});
+            bricks.push_back(e);
+        }
+    }
+};
+
+// Um campo por tamanho, construido na primeira execucao e reusado nas seguintes: o runner
+// chama cada benchmark varias vezes (calibracao e repeticoes) e criar/destruir ate 100k
+// entidades nao pode entrar na medicao. Nenhum benchmark altera o registry (a bola nunca
+// chega aos tijolos)
+BrickField& brickField(size_t n, bool halfDestroyed) {
+    static std::map<std::pair<size_t, bool>, std::unique_ptr<BrickField>> fields;
+    std::unique_ptr<BrickField>& field = fields[std::make_pair(n, halfDestroyed)];
+    if (!field) {
+        field.reset(new BrickField(n));
+        if (halfDestroyed) {
+            for (size_t i = 0; i < field->bricks.size(); i += 2) field->world.destroy(field->bricks[i]);
+        }
+    }
+    return *field;
+}
+
+void BM_BallBrickMiss(State& state) {
+    Ball ball(glm::vec3(0.0f, -5.0f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+    Transform brick{ glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(2.0f, 0.8f, 1.0f) };
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        doNotOptimize(Collision::ballBrick(ball, brick));
+    }
+    state.setItemsProcessed(state.iterations);
+}
+
+void BM_BallBrickHit(State& state) {
+    Transform brick{ glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(2.0f, 0.8f, 1.0f) };
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        // Bola a entrar pela face de baixo; a resolucao altera-a, por isso e reposta a cada iteracao
+        Ball ball(glm::vec3(0.3f, 7.3f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+        doNotOptimize(Collision::ballBrick(ball, brick));
+        doNotOptimize(ball.velocity);
+    }
+    state.setItemsProcessed(state.iterations);
+}
+
+void BM_BallPaddle(State& state) {
+    Ball ball(glm::vec3(0.5f, -7.5f, 0.0f), glm::vec3(8.0f, -12.0f, 0.0f), 0.5f);
+    Paddle paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        doNotOptimize(Collision::ballPaddle(ball, paddle));
+    }
+    state.setItemsProcessed(state.iterations);
+}
+
+// Frame tipico: a bola anda abaixo dos tijolos e o loop testa todos sem acertar em nenhum
+void BM_CheckCollisions(State& state) {
+    state.pauseTiming();
+    BrickField& field = brickField((size_t)state.arg, false);
+    state.resumeTiming();
+    Ball ball(glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+    Paddle paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        doNotOptimize(Collision::resolve(ball, paddle, field.world, BOUNCE_SPEED));
+    }
+    state.setItemsProcessed(state.iterations * field.bricks.size());
+}
+
+// Metade dos tijolos ja destruidos: os arrays densos encolhem, mas a ordem fica baralhada
+void BM_CheckCollisionsHalfDestroyed(State& state) {
+    state.pauseTiming();
+    BrickField& field = brickField((size_t)state.arg, true);
+    state.resumeTiming();
+    Ball ball(glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(8.0f, 12.0f, 0.0f), 0.5f);
+    Paddle paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        doNotOptimize(Collision::resolve(ball, paddle, field.world, BOUNCE_SPEED));
+    }
+    state.setItemsProcessed(state.iterations * field.bricks.size());
+}
+
+// As matrizes model que o Game::renderScene calcula para cada tijolo vivo
+void BM_BrickModelMatrices(State& state) {
+    state.pauseTiming();
+    BrickField& field = brickField((size_t)state.arg, false);
+    glm::mat4 gameBase(1.0f);
+    gameBase = glm::translate(gameBase, glm::vec3(0.654f, -4.912f, -0.903f));
+    gameBase = glm::rotate(gameBase, glm::radians(-89.6f), glm::vec3(0, 1, 0));
+    gameBase = glm::rotate(gameBase, glm::radians(-18.7f), glm::vec3(1, 0, 0));
+    gameBase = glm::scale(gameBase, glm::vec3(0.0139f));
+    std::vector<glm::mat4> matrices(field.bricks.size());
+    state.resumeTiming();
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        const Transform* transforms = field.world.pool<Transform>().data();
+        for (size_t b = 0; b < field.bricks.size(); b++) {
+            matrices[b] = Geometry::boardModelMatrix(gameBase, transforms[b].position, transforms[b].size);
+        }
+        doNotOptimize(matrices.data());
+    }
+    state.setItemsProcessed(state.iterations * field.bricks.size());
+}
+
+// Argumento = sectores (stacks = sectores / 2); o jogo usa 32x16
+void BM_CreateSphere(State& state) {
+    std::vector<float> vertices;
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        Geometry::buildSphere(1.0f, (int)state.arg, (int)state.arg / 2, vertices);
+        doNotOptimize(vertices.data());
+    }
+    state.setItemsProcessed(state.iterations * (vertices.size() / 6));
+}
+
+// Argumento = caixas numa grelha de 20x20x20 unidades a volta da camara do jogo (metade fica fora)
+void BM_FrustumCull(State& state) {
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, -4.6f, -0.9f), glm::vec3(1.0f, -5.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum(projection * view);
+    std::vector<Aabb> boxes(state.arg);
+    size_t side = 1;
+    while (side * side * side < boxes.size()) side++;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        glm::vec3 cell((float)(i % side), (float)(i / side % side), (float)(i / (side * side)));
+        glm::vec3 min = glm::vec3(-10.0f) + cell * (20.0f / side);
+        boxes[i] = Aabb{ min, min + glm::vec3(10.0f / side) };
+    }
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        unsigned visible = 0;
+        for (const Aabb& box : boxes) visible += frustum.intersects(box);
+        doNotOptimize(visible);
+    }
+    state.setItemsProcessed(state.iterations * boxes.size());
+}
+
+#ifdef MICROBENCH_MODEL3D
+const char* ARCADE_OBJ = "arcade/uploads_files_2611707_ArcadeRoom_V1.obj";
+
+// O load() escreve no cout; silenciado para nao poluir a tabela
+struct MuteCout {
+    std::ostringstream sink;
+    std::streambuf* previous;
+    MuteCout() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~MuteCout() { std::cout.rdbuf(previous); }
+};
+
+// So a parte de CPU: parser OBJ, materiais, bounds e centragem (sem upload para o GL)
+void BM_Model3DLoad(State& state) {
+    MuteCout mute;
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        Model3D model(ARCADE_OBJ, "arcade/");
+        doNotOptimize(model.load());
+    }
+}
+
+void BM_Model3DCalculateBounds(State& state) {
+    MuteCout mute;
+    static Model3D model(ARCADE_OBJ, "arcade/");
+    if (!model.loaded()) model.load();
+    for (uint64_t i = 0; i < state.iterations; i++) {
+        model.calculateBounds();
+        doNotOptimize(model.getMaxDimension());
+    }
+}
+#endif
+
+} // namespace
+
+MICROBENCH(BM_BallBrickMiss);
+MICROBENCH(BM_BallBrickHit);
+MICROBENCH(BM_BallPaddle);
+MICROBENCH_ARGS(BM_CheckCollisions, 50, 1000, 100000);
+MICROBENCH_ARGS(BM_CheckCollisionsHalfDestroyed, 50, 1000, 100000);
+MICROBENCH_ARGS(BM_BrickModelMatrices, 50, 1000, 100000);
+MICROBENCH_ARGS(BM_CreateSphere, 32, 64, 128);
+MICROBENCH_ARGS(BM_FrustumCull, 137, 1000, 100000);
+#ifdef MICROBENCH_MODEL3D
+MICROBENCH(BM_Model3DLoad);
+MICROBENCH(BM_Model3DCalculateBounds);
+#endif
+
+int main(int argc, char** argv) {
+    microbench::Runner runner;
+    if (!runner.parseArgs(argc, argv)) return 1;
+    return runner.runAll();
+}
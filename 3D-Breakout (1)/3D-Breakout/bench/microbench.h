@@ -0,0 +1,217 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+// Harness minimo de microbenchmarks (no estilo do Google Benchmark, sem dependencias).
+// Cada benchmark recebe um State com o numero de iteracoes e o argumento (p.ex. numero
+// de tijolos); o runner calibra as iteracoes para ~minTime por repeticao e reporta a
+// mediana de varias repeticoes. --json grava os resultados para seguir tendencias.
+//
+//   static void BM_Foo(microbench::State& state) {
+//       for (uint64_t i = 0; i < state.iterations; i++) microbench::doNotOptimize(foo(state.arg));
+//   }
+//   MICROBENCH_ARGS(BM_Foo, 50, 1000);
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace microbench {
+
+template <class T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+class State {
+public:
+    State(uint64_t iterations, int64_t arg) : iterations(iterations), arg(arg), items(0), excludedNs(0) {}
+
+    const uint64_t iterations;
+    const int64_t arg;
+
+    // Elementos processados no total (para items/s), p.ex. iterations * tijolos
+    void setItemsProcessed(uint64_t count) { items = count; }
+
+    // Exclui da medicao a preparacao feita a meio do loop (p.ex. repor tijolos destruidos)
+    void pauseTiming() { pauseStart = std::chrono::steady_clock::now(); }
+    void resumeTiming() { excludedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pauseStart).count(); }
+
+private:
+    friend class Runner;
+    uint64_t items;
+    double excludedNs;
+    std::chrono::steady_clock::time_point pauseStart;
+};
+
+typedef void (*BenchFn)(State&);
+
+struct Benchmark {
+    std::string name;
+    BenchFn fn;
+    std::vector<int64_t> args;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const char* name, BenchFn fn, std::initializer_list<int64_t> args = {}) {
+        registry().push_back(Benchmark{ name, fn, std::vector<int64_t>(args) });
+    }
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double medianNs, minNs, meanNs, stddevNs;
+    double itemsPerSecond;
+};
+
+class Runner {
+public:
+    double minTime = 0.25;     // segundos por repeticao
+    int repetitions = 5;
+    std::string filter;
+    std::string jsonPath;
+
+    bool parseArgs(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+            else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+            else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) minTime = std::atof(argv[++i]);
+            else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) repetitions = std::max(1, std::atoi(argv[++i]));
+            else {
+                std::fprintf(stderr, "usage: %s [--filter substr] [--json out.json] [--min-time s] [--repetitions n]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int runAll() {
+        std::vector<Result> results;
+        std::printf("%-40s %14s %14s %14s %12s\n", "benchmark", "median", "min", "items/s", "iterations");
+        for (const Benchmark& bench : registry()) {
+            std::vector<int64_t> args = bench.args.empty() ? std::vector<int64_t>{ 0 } : bench.args;
+            for (int64_t arg : args) {
+                std::string name = bench.name + (bench.args.empty() ? "" : "/" + std::to_string(arg));
+                if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+                Result r = run(name, bench.fn, arg);
+                std::printf("%-40s %14s %14s %14s %12llu\n", r.name.c_str(), formatNs(r.medianNs).c_str(), formatNs(r.minNs).c_str(),
+                            r.itemsPerSecond > 0.0 ? formatRate(r.itemsPerSecond).c_str() : "-", (unsigned long long)r.iterations);
+                std::fflush(stdout);
+                results.push_back(r);
+            }
+        }
+        if (!jsonPath.empty() && !writeJson(results)) return 1;
+        return 0;
+    }
+
+private:
+    // Devolve ns por iteracao e items/s de uma execucao com n iteracoes
+    static double timeOnce(BenchFn fn, uint64_t n, int64_t arg, double& itemsPerSecond) {
+        State state(n, arg);
+        auto start = std::chrono::steady_clock::now();
+        fn(state);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() - state.excludedNs;
+        itemsPerSecond = state.items && ns > 0.0 ? state.items / (ns * 1e-9) : 0.0;
+        return ns / (double)n;
+    }
+
+    Result run(const std::string& name, BenchFn fn, int64_t arg) {
+        // Calibracao: cresce as iteracoes ate uma execucao durar ~10% do minTime
+        double rate = 0.0;
+        uint64_t n = 1;
+        double perIter = timeOnce(fn, n, arg, rate);
+        while (perIter * n < minTime * 1e9 * 0.1 && n < (1ull << 40)) {
+            n *= 10;
+            perIter = timeOnce(fn, n, arg, rate);
+        }
+        n = std::max<uint64_t>(1, (uint64_t)(minTime * 1e9 / std::max(perIter, 1e-3)));
+
+        std::vector<double> samples, rates;
+        for (int rep = 0; rep < repetitions; rep++) {
+            samples.push_back(timeOnce(fn, n, arg, rate));
+            rates.push_back(rate);
+        }
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        std::sort(rates.begin(), rates.end());
+        double mean = 0.0, var = 0.0;
+        for (double s : samples) mean += s;
+        mean /= samples.size();
+        for (double s : samples) var += (s - mean) * (s - mean);
+
+        Result r;
+        r.name = name;
+        r.iterations = n;
+        r.medianNs = sorted[sorted.size() / 2];
+        r.minNs = sorted.front();
+        r.meanNs = mean;
+        r.stddevNs = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+        r.itemsPerSecond = rates[rates.size() / 2];
+        return r;
+    }
+
+    static std::string formatNs(double ns) {
+        char buf[32];
+        if (ns >= 1e6) std::snprintf(buf, sizeof(buf), "%.3f ms", ns / 1e6);
+        else if (ns >= 1e3) std::snprintf(buf, sizeof(buf), "%.3f us", ns / 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.2f ns", ns);
+        return buf;
+    }
+
+    static std::string formatRate(double perSecond) {
+        char buf[32];
+        if (perSecond >= 1e9) std::snprintf(buf, sizeof(buf), "%.2f G/s", perSecond / 1e9);
+        else if (perSecond >= 1e6) std::snprintf(buf, sizeof(buf), "%.2f M/s", perSecond / 1e6);
+        else std::snprintf(buf, sizeof(buf), "%.2f k/s", perSecond / 1e3);
+        return buf;
+    }
+
+    // Formato proximo do --benchmark_format=json do Google Benchmark
+    bool writeJson(const std::vector<Result>& results) const {
+        FILE* file = std::fopen(jsonPath.c_str(), "w");
+        if (!file) { std::fprintf(stderr, "microbench: cannot write %s\n", jsonPath.c_str()); return false; }
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        std::fprintf(file, "{\n  \"context\": { \"date\": \"%s\", \"num_cpus\": %u, \"repetitions\": %d, \"min_time_s\": %.3f },\n",
+                     date, std::thread::hardware_concurrency(), repetitions, minTime);
+        std::fprintf(file, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            std::fprintf(file, "    { \"name\": \"%s\", \"iterations\": %llu, \"real_time\": %.4f, \"min_time\": %.4f, \"mean_time\": %.4f, "
+                               "\"stddev_time\": %.4f, \"time_unit\": \"ns\", \"items_per_second\": %.1f }%s\n",
+                         r.name.c_str(), (unsigned long long)r.iterations, r.medianNs, r.minNs, r.meanNs, r.stddevNs, r.itemsPerSecond,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+        std::printf("results -> %s\n", jsonPath.c_str());
+        return true;
+    }
+};
+
+} // namespace microbench
+
+#define MICROBENCH(fn) static microbench::Registrar fn##_registrar(#fn, fn)
+#define MICROBENCH_ARGS(fn, ...) static microbench::Registrar fn##_registrar(#fn, fn, { __VA_ARGS__ })
+
+#endif
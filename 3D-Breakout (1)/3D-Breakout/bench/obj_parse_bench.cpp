@@ -0,0 +1,46 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "ObjParser.hpp"
+
+// Compara o throughput (MB/s) do caminho tinyobj com o parser em streaming
+// Uso: obj_parse_bench [ficheiro.obj] [pasta_base] [iteracoes]
+
+typedef bool (*LoadFn)(const std::string&, const std::string&, ObjData&, std::string&);
+
+static size_t totalVertices(const ObjData& data) {
+    size_t total = 0;
+    for (const auto& mesh : data.meshes) total += mesh.vertexCount;
+    return total;
+}
+
+static double runBench(const char* name, LoadFn load, const std::string& path, const std::string& base, int iterations) {
+    ObjData data;
+    std::string err;
+    if (!load(path, base, data, err)) { std::cerr << name << ": failed: " << err << std::endl; return 0.0; }
+
+    double best = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        load(path, base, data, err);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best) best = seconds;
+    }
+    double mbps = (data.sourceBytes / (1024.0 * 1024.0)) / best;
+    std::cout << name << ": " << best * 1000.0 << " ms, " << mbps << " MB/s, "
+              << data.meshes.size() << " meshes, " << totalVertices(data) << " vertices" << std::endl;
+    return mbps;
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "arcade/uploads_files_2611707_ArcadeRoom_V1.obj";
+    std::string base = argc > 2 ? argv[2] : "arcade/";
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 10;
+
+    double tiny = runBench("tinyobj  ", ObjParser::loadTinyObj, path, base, iterations);
+    double streaming = runBench("streaming", ObjParser::loadStreaming, path, base, iterations);
+    if (tiny > 0.0) std::cout << "speedup: " << streaming / tiny << "x" << std::endl;
+    return 0;
+}
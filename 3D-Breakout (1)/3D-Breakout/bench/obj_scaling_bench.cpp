@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ObjParser.hpp"
+
+// Escalabilidade do parser OBJ multithread (1-16 threads) sobre um OBJ sintetico grande.
+// Cada medida usa um JobSystem proprio com threads-1 workers (mais a thread principal)
+// Uso: obj_scaling_bench [MB] [ficheiro_saida.obj]
+
+// Grelha de caixas com quads; metade das caixas usa indices negativos (relativos)
+static std::string generateSyntheticObj(size_t targetBytes) {
+    std::string obj;
+    obj.reserve(targetBytes + 4096);
+    obj += "# 3D Breakout synthetic arcade\n";
+    char line[256];
+    size_t box = 0, vBase = 0;
+    while (obj.size() < targetBytes) {
+        float x = (float)(box % 256) * 2.0f, z = (float)((box / 256) % 256) * 2.0f, y = (float)(box / 65536) * 2.0f;
+        if (box % 64 == 0) { std::snprintf(line, sizeof(line), "usemtl mat%zu\n", (box / 64) % 8); obj += line; }
+        for (int c = 0; c < 8; c++) {
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1));
+            obj += line;
+        }
+        for (int c = 0; c < 4; c++) {
+            std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", (float)(c & 1), (float)(c >> 1));
+            obj += line;
+        }
+        obj += "vn 0.000000 1.000000 0.000000\n";
+        static const int quads[6][4] = { {0,1,3,2}, {4,6,7,5}, {0,4,5,1}, {2,3,7,6}, {0,2,6,4}, {1,5,7,3} };
+        for (const auto& q : quads) {
+            if (box % 2 == 0) {
+                std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                              vBase + q[0] + 1, box * 4 + 1, box + 1, vBase + q[1] + 1, box * 4 + 2, box + 1,
+                              vBase + q[2] + 1, box * 4 + 4, box + 1, vBase + q[3] + 1, box * 4 + 3, box + 1);
+            } else {
+                std::snprintf(line, sizeof(line), "f %d/-4/-1 %d/-3/-1 %d/-1/-1 %d/-2/-1\n", q[0] - 8, q[1] - 8, q[2] - 8, q[3] - 8);
+            }
+            obj += line;
+        }
+        vBase += 8;
+        box++;
+    }
+    return obj;
+}
+
+static bool sameResult(const ObjData& a, const ObjData& b) {
+    if (a.meshes.size() != b.meshes.size()) return false;
+    for (size_t i = 0; i < a.meshes.size(); i++) {
+        const auto& va = a.meshes[i].vertices;
+        const auto& vb = b.meshes[i].vertices;
+        if (va.size() != vb.size() || std::memcmp(va.data(), vb.data(), va.size() * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? (size_t)std::atoi(argv[1]) : 256;
+    std::string obj = generateSyntheticObj(megabytes * 1024 * 1024);
+    if (argc > 2) std::ofstream(argv[2], std::ios::binary).write(obj.data(), obj.size());
+    double sizeMB = obj.size() / (1024.0 * 1024.0);
+    std::cout << "synthetic OBJ: " << sizeMB << " MB" << std::endl;
+
+    ObjData reference, data;
+    std::string err;
+    auto start = std::chrono::steady_clock::now();
+    if (!ObjParser::parseStreaming(obj.data(), obj.size(), "", reference, err)) { std::cerr << err << std::endl; return 1; }
+    double baseline = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "streaming : " << baseline * 1000.0 << " ms, " << sizeMB / baseline << " MB/s" << std::endl;
+
+    for (unsigned threads = 1; threads <= 16; threads *= 2) {
+        JobSystem pool(threads - 1);
+        start = std::chrono::steady_clock::now();
+        if (!ObjParser::parseParallel(obj.data(), obj.size(), "", data, err, threads, &pool)) { std::cerr << err << std::endl; return 1; }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "threads " << threads << (threads < 10 ? " " : "") << ": " << seconds * 1000.0 << " ms, "
+                  << sizeMB / seconds << " MB/s, speedup " << baseline / seconds << "x"
+                  << (sameResult(reference, data) ? "" : "  MISMATCH") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+# PGO em duas fases, corrido com cmake -P pelo alvo "pgo" do CMakeLists.txt.
+# As duas fases usam a mesma pasta de build: o GCC identifica os perfis (.gcda)
+# pelo caminho dos objectos, por isso o build final tem de ter os mesmos caminhos.
+set(PROFILE_DIR "${BINARY_DIR}/profiles")
+
+macro(run_step description)
+    message(STATUS "PGO: ${description}")
+    execute_process(COMMAND ${ARGN} WORKING_DIRECTORY "${SOURCE_DIR}" RESULT_VARIABLE step_result)
+    if(NOT step_result EQUAL 0)
+        message(FATAL_ERROR "PGO: '${description}' failed (${step_result})")
+    endif()
+endmacro()
+
+set(CONFIGURE_ARGS
+    -S "${SOURCE_DIR}" -B "${BINARY_DIR}" -G "${GENERATOR}"
+    -DCMAKE_BUILD_TYPE=Release
+    "-DCMAKE_CXX_COMPILER=${CXX_COMPILER}"
+    "-DBREAKOUT_BUILD_GAME=${BUILD_GAME}"
+    "-DBREAKOUT_LTO=${LTO}"
+    "-DBREAKOUT_LZ4=${LZ4}"
+    "-DBREAKOUT_MARCH=${MARCH}"
+    "-DBREAKOUT_PGO_DIR=${PROFILE_DIR}")
+if(GLM_INCLUDE_DIR)
+    list(APPEND CONFIGURE_ARGS "-DGLM_INCLUDE_DIR=${GLM_INCLUDE_DIR}")
+endif()
+
+file(REMOVE_RECURSE "${PROFILE_DIR}")
+run_step("configure instrumented build" "${CMAKE_COMMAND}" ${CONFIGURE_ARGS} -DBREAKOUT_PGO=GENERATE)
+run_step("build instrumented binaries" "${CMAKE_COMMAND}" --build "${BINARY_DIR}" --clean-first)
+
+# Treino: o parser com o OBJ do arcade e o jogo completo em modo benchmark (bot + camara)
+run_step("train obj parser" "${BINARY_DIR}/obj_parse_bench${EXE_SUFFIX}")
+if(BUILD_GAME)
+    set(GAME_ARGS --bench 600 --bench-out "${BINARY_DIR}/pgo_train_report.json")
+    if(HEADLESS)
+        list(APPEND GAME_ARGS --headless 1280x720)
+    endif()
+    run_step("train game benchmark" "${BINARY_DIR}/3D_Breakout${EXE_SUFFIX}" ${GAME_ARGS})
+endif()
+
+if(CXX_COMPILER_ID MATCHES "Clang")
+    get_filename_component(COMPILER_DIR "${CXX_COMPILER}" DIRECTORY)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS "${COMPILER_DIR}")
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "PGO: llvm-profdata not found")
+    endif()
+    file(GLOB RAW_PROFILES "${PROFILE_DIR}/*.profraw")
+    run_step("merge profiles" "${LLVM_PROFDATA}" merge "-output=${PROFILE_DIR}/breakout.profdata" ${RAW_PROFILES})
+endif()
+
+run_step("configure optimized build" "${CMAKE_COMMAND}" ${CONFIGURE_ARGS} -DBREAKOUT_PGO=USE)
+run_step("build optimized binaries" "${CMAKE_COMMAND}" --build "${BINARY_DIR}" --clean-first)
+message(STATUS "PGO: optimized binaries in ${BINARY_DIR}")
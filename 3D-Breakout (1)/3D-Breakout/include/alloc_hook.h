@@ -0,0 +1,21 @@
+#ifndef ALLOC_HOOK_H
+#define ALLOC_HOOK_H
+
+#include <cstdint>
+
+struct AllocCounters {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;
+};
+
+// Contagem das alocacoes C++ (operator new/delete globais, substituidos em alloc_hook.cpp).
+// Os contadores sao por thread: sem atomicos nem partilha no caminho do new.
+// Com BREAKOUT_NO_ALLOC_HOOK ficam os operadores da biblioteca e os contadores a zero
+class AllocHook {
+public:
+    static bool enabled();
+    static const AllocCounters& thisThread();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+#include "latency.h"
+
+// Modo benchmark (--bench <frames> ou --bench <segundos>s): sem menu, paddle conduzido
+// por um bot, camara num percurso fixo e simulacao com passo fixo, para que todas as
+// maquinas e builds corram exactamente a mesma sequencia de frames
+class Benchmark {
+public:
+    static const int WARMUP_FRAMES = 30;
+    static constexpr float FIXED_DT = 1.0f / 60.0f;
+
+    bool active;
+    bool threaded;    // --threaded: simulacao e render em threads separadas (vai no relatorio)
+    const char* sphereMode;    // --spheres: "mesh" ou "impostor"
+    unsigned sphereCount;      // bola do jogo mais as de --bench-balls
+    const char* roomLighting;  // --room-lighting: "baked" ou "phong"
+    std::string reportPath;
+
+    Benchmark();
+
+    bool parse(const std::string& arg);     // "600" = frames, "30s" = segundos
+    bool finished(double elapsedSeconds) const;
+
+    // Percurso da camara dentro dos limites de Game::processMouseMovement
+    void cameraAt(unsigned frame, float& yaw, float& pitch) const;
+
+    // heapAllocs: operator new do frame (simulacao e render); depois do aquecimento deve ser 0
+    void recordFrame(float frameMs, unsigned drawCalls, unsigned long long triangles, unsigned long long heapAllocs);
+    void setLatency(const LatencyStats& stats) { latencyStats = stats; }
+    bool writeReport(const std::string& renderer, double elapsedSeconds) const;
+
+    unsigned frames() const { return frameCount; }
+
+private:
+    unsigned targetFrames;
+    double targetSeconds;
+    unsigned frameCount;
+
+    std::vector<float> frameTimes;
+    unsigned long long totalDrawCalls;
+    unsigned long long totalTriangles;
+    unsigned long long totalHeapAllocs;
+    unsigned framesWithAllocs;
+    LatencyStats latencyStats;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef BTEX_H
+#define BTEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Textura cozinhada offline (tools/cook_textures): cadeia de mipmaps completa,
+// em BC1/BC3 (S3TC) ou RGBA8. Ficheiro: BtexHeader | { BtexLevel | dados }[levels]
+const char BTEX_MAGIC[4] = { 'B', 'T', 'E', 'X' };
+const char* const BTEX_EXTENSION = ".btex";
+
+enum BtexFormat : uint32_t {
+    BTEX_RGBA8 = 0,
+    BTEX_BC1 = 1,    // RGB, 8 bytes por bloco 4x4
+    BTEX_BC3 = 2     // RGBA, 16 bytes por bloco 4x4
+};
+
+struct BtexHeader {
+    char magic[4];
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levels;
+};
+
+struct BtexLevel {
+    uint32_t width;
+    uint32_t height;
+    uint32_t size;
+};
+
+struct BtexMip {
+    uint32_t width;
+    uint32_t height;
+    const uint8_t* data;
+    uint32_t size;
+};
+
+class BtexImage {
+public:
+    uint32_t format = BTEX_RGBA8;
+    std::vector<BtexMip> mips;
+
+    // Os mips apontam para o buffer original (normalmente memoria do Vfs)
+    bool parse(const char* data, size_t size);
+
+    static size_t levelSize(uint32_t format, uint32_t width, uint32_t height);
+    static void decodeToRgba(uint32_t format, const uint8_t* src, uint32_t width, uint32_t height, std::vector<uint8_t>& rgba);
+};
+
+#endif
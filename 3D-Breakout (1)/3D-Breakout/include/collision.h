@@ -0,0 +1,34 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "ball.h"
+#include "components.h"
+#include "jobs.h"
+#include "paddle.h"
+#include "registry.h"
+
+// A partir daqui a procura de tijolos perto da bola e dividida em jobs
+const size_t PARALLEL_MIN_BRICKS = 4096;
+
+// Chamada para cada tijolo atingido, antes de sair do registry (os componentes ainda existem)
+typedef void (*BrickHitFunction)(void* context, Registry& world, Entity brick);
+
+// Colisoes da bola no plano XY do tabuleiro, sem dependencias de OpenGL
+// (usadas pelo Game e pelos microbenchmarks)
+class Collision {
+public:
+    // AABB da bola contra o paddle; so conta com a bola a descer
+    static bool ballPaddle(const Ball& ball, const Paddle& paddle);
+
+    // Circulo contra o rectangulo do tijolo. Em caso de colisao reflecte a bola
+    // no eixo da face atingida e tira-a de dentro do tijolo
+    static bool ballBrick(Ball& ball, const Transform& brick);
+
+    // Paddle e depois as entidades com Transform e Breakable; as atingidas sao destruidas no
+    // registry e devolve-se quantas. Com muitas entidades a fase larga corre em paralelo sobre
+    // o array denso de Transform, a resposta continua em serie
+    static int resolve(Ball& ball, const Paddle& paddle, Registry& world, float bounceSpeed, JobSystem& pool = jobs(),
+                       BrickHitFunction onHit = nullptr, void* context = nullptr);
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <glm/glm.hpp>
+
+// Componentes das entidades do Registry (um array denso por tipo)
+
+// Centro e tamanho no plano do tabuleiro (XY); o que a fisica e o render leem
+struct Transform {
+    glm::vec3 position;
+    glm::vec3 size;
+};
+
+struct Tint {
+    glm::vec3 color;
+};
+
+// Destruida ao primeiro toque da bola (tijolos)
+struct Breakable {};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bump allocator: allocate() so avanca um ponteiro e tudo e libertado de uma vez em reset().
+// Se o bloco enche, o excesso vai para blocos extra do heap e no reset seguinte o bloco
+// principal cresce para o pico observado; a partir dai nao ha mais mallocs
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+    void reset();
+
+    size_t used() const { return offset + overflowBytes; }
+    size_t capacity() const { return size; }
+    size_t highWater() const { return peak; }
+
+private:
+    struct Overflow {
+        Overflow* next;
+    };
+
+    char* block;
+    size_t size;
+    size_t offset;
+    size_t peak;
+    size_t overflowBytes;
+    Overflow* overflow;    // blocos extra deste frame, libertados no reset
+};
+
+// Duas arenas alternadas por frame: o que foi alocado no frame N continua valido durante
+// o frame N+1, o tempo de a thread de render ler o que a simulacao lhe passou
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+
+    // No inicio do frame da thread dona: troca de arena e liberta a de ha dois frames
+    void beginFrame();
+    LinearArena& current() { return arenas[index]; }
+
+private:
+    LinearArena arenas[2];
+    unsigned index;
+};
+
+// Arena da thread actual (cada thread que desenha ou simula tem a sua)
+FrameArena& frameArena();
+
+// Adaptador para contentores da STL: deallocate nao faz nada, a memoria volta no reset.
+// O contentor nao pode sobreviver ao frame seguinte ao da alocacao
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(LinearArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    LinearArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+
+// Ritmo do loop principal. Nos ecras parados (menu, vitoria, derrota) so a camara
+// pode mudar e so com input, por isso o loop dorme em glfwWaitEventsTimeout e so
+// desenha depois de um evento. Durante o jogo aplica um limite de fps opcional.
+// Conta frames e tempo de CPU em cada modo para comparar consumo em idle.
+class FramePacer {
+public:
+    static constexpr double IDLE_WAIT_SECONDS = 0.5;
+    static const int IDLE_REDRAW_FRAMES = 3;    // o ImGui precisa de alguns frames para assentar o layout
+
+    bool idleThrottle;    // --no-idle-throttle desliga
+    int frameCap;         // --frame-cap <fps>, 0 = sem limite (so vsync)
+
+    FramePacer();
+
+    // Callbacks de input/janela: o proximo frame tem de ser desenhado
+    void requestRedraw() { redrawRequested = true; }
+
+    // No inicio de cada iteracao. Devolve false se nao ha nada para desenhar
+    bool waitForWork(bool animating);
+
+    // Depois do swap: dorme o que falta para respeitar o frameCap
+    void limitFrameRate(bool animating);
+
+    void printReport() const;
+
+private:
+    struct ModeStats {
+        double wallSeconds;
+        double cpuSeconds;
+        uint64_t frames;
+    };
+
+    bool redrawRequested;
+    int redrawFrames;
+    bool wasAnimating;
+    bool idleMode;
+    double lastSampleWall, lastSampleCpu;
+    double frameDeadline;
+    ModeStats idle, active;
+
+    void accountTime();
+};
+
+#endif
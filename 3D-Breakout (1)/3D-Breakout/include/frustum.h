@@ -0,0 +1,44 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// Caixa alinhada aos eixos; vazia = min acima de max
+struct Aabb {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    static Aabb empty() { return Aabb{ glm::vec3(1e30f), glm::vec3(-1e30f) }; }
+    void expand(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+    void expand(const Aabb& other) { min = glm::min(min, other.min); max = glm::max(max, other.max); }
+    bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+};
+
+// Cone das normais de um grupo de triangulos: cutoff = seno do maior desvio ao eixo
+// (maior que 1 = normais demasiado espalhadas, nunca se rejeita)
+struct NormalCone {
+    glm::vec3 axis;
+    float cutoff;
+
+    static NormalCone disabled() { return NormalCone{ glm::vec3(0.0f, 0.0f, 1.0f), 2.0f }; }
+
+    // Todos os triangulos dentro de bounds estao de costas para eye: com back-face culling
+    // nenhum chegaria ao ecra. Conservador; exacto para faces alinhadas com os eixos (cutoff 0)
+    bool backfacing(const glm::vec3& eye, const Aabb& bounds) const;
+};
+
+// Os seis planos de uma matriz de recorte (Gribb/Hartmann), normais para dentro.
+// Com projection * view * model os planos ficam no espaco do modelo e as caixas
+// calculadas no load servem directamente
+class Frustum {
+public:
+    explicit Frustum(const glm::mat4& clip);
+
+    // Conservador: so rejeita a caixa se estiver toda fora de algum plano
+    bool intersects(const Aabb& box) const;
+
+private:
+    glm::vec4 planes[6];
+};
+
+#endif
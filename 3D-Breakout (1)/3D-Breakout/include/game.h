@@ -10,8 +10,23 @@
 #include "renderer.h"
 #include "ball.h"
 #include "paddle.h"
-#include "brick.h"
-#include "..\src\Model3D.hpp"
+#include "components.h"
+#include "particles.h"
+#include "gpu_particles.h"
+#include "registry.h"
+#include "input_queue.h"
+#include "../src/Model3D.hpp"
+
+// Limites da camara (graus), partilhados pelo rato e pelo percurso do benchmark
+const float CAMERA_PITCH_MIN = -43.445f;
+const float CAMERA_PITCH_MAX = -8.858f;
+const float CAMERA_YAW_MIN = 7.677f;
+const float CAMERA_YAW_MAX = 78.484f;
+
+// Passo fixo da simulacao; o render interpola entre os dois ultimos passos
+const double SIM_STEP = 1.0 / 120.0;
+// Depois de um engasgo grande (carregamento, debugger) nao se tenta recuperar o tempo todo
+const double SIM_MAX_CATCHUP = 0.25;
 
 enum GameState {
     GAME_ACTIVE,
@@ -20,37 +35,100 @@ enum GameState {
     GAME_LOSE
 };
 
+struct BrickInstance {
+    glm::vec3 position;
+    glm::vec3 size;
+    glm::vec3 color;
+};
+
+// Tudo o que o render precisa de um frame, copiado da simulacao. Com --threaded a
+// simulacao publica-os num TripleBuffer e a thread de render so le esta copia
+struct RenderSnapshot {
+    GameState state;
+    unsigned int width, height;
+    unsigned int score;
+    int lives;
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 cameraPos;
+    glm::vec3 paddlePosition;   // ja interpolada entre os dois ultimos passos
+    glm::vec3 paddleSize;
+    std::vector<glm::vec4> spheres;       // centro no tabuleiro e raio: a bola (interpolada) e as do benchmark
+    std::vector<BrickInstance> bricks;    // so os vivos; a capacidade fica entre frames
+    std::vector<ParticleInstance> particles;    // reservado para a pool inteira no primeiro snapshot
+    uint64_t simTimeNs;                   // relogio da simulacao (interpolado) para as particulas GPU
+    unsigned levelClears;                 // muda quando o nivel e limpo: dispara a explosao na GPU
+    uint64_t inputNs, sampleNs;           // para o LatencyTracker do lado do render
+};
+
 class Game {
 public:
     GameState state;
-    bool keys[1024];
+    InputQueue input;    // eventos de teclado dos callbacks GLFW, consumidos por advance()
     unsigned int width, height;
+    bool autopilot;    // bot do modo benchmark: arranca sozinho e segue a bola
+    unsigned benchBalls;    // bolas extra so desenhadas (--bench-balls), para medir o caminho das esferas
+    bool sphereImpostors;   // esferas como quads com ray casting no fragment (--spheres impostor) ou malha
+    bool bakedRoomLighting; // sala com a luz cozinhada nos vertices e shader sem luz (--room-lighting baked) ou Phong
 
     Game(unsigned int width, unsigned int height);
     ~Game();
     
     void init();
-    void processInput(float dt);
-    void update(float dt);
-    void render();
+    // Corre os passos fixos ate nowNs (relogio do Trace), aplicando cada evento de input
+    // no instante em que aconteceu dentro do passo
+    void advance(uint64_t nowNs);
+    void snapshot(RenderSnapshot& out) const;
+    // So usa o snapshot e os recursos GL criados em init(): pode correr noutra thread
+    void render(const RenderSnapshot& frame) const;
+    // Fora do jogo (menu, vitoria, derrota) a cena so muda com input, com particulas no ar ou
+    // com a explosao da GPU do ultimo nivel limpo
+    bool isAnimating() const;
     void processMouseMovement(float xpos, float ypos);
+    void setCameraAngles(float yaw, float pitch);
     void updateResolution(unsigned int w, unsigned int h);
 
 private:
     void reset();
     void createBricks();
+    void applyInput(const InputEvent& event);
+    void movePaddle(float seconds);
+    void update(float dt);
     void checkCollisions();
-    bool checkBallPaddleCollision();
-    bool checkBallBrickCollision(Brick* b);
+    static void onBrickHit(void* context, Registry& world, Entity brick);
     void updateCamera();
     void loadArcadeModel();
-    void renderUI(); 
+    glm::mat4 arcadeTransform() const;
+    void renderScene(const RenderSnapshot& frame) const;
+    void renderUI(const RenderSnapshot& frame) const;
+    void renderParticles(const RenderSnapshot& frame, const glm::mat4& gameBase) const;
+    void renderGpuParticles(const RenderSnapshot& frame, const glm::mat4& gameBase) const;
+    void renderSpheres(const RenderSnapshot& frame, const glm::mat4& gameBase) const;
 
     Renderer* renderer;
     Shader* shader;
+    Shader* particleShader;
+    Shader* impostorShader;
+    Shader* roomShader;
     Ball* ball;
     Paddle* paddle;
-    std::vector<Brick*> bricks;
+    Registry world;    // tijolos (Transform + Tint + Breakable); power-ups e bolas extra cabem aqui
+    ParticlePool particles;    // detritos e faiscas dos tijolos partidos
+    // Efeitos pesados simulados na GPU: explosao do tabuleiro ao limpar o nivel e poeira da sala.
+    // Sao da thread que desenha; o relogio e a ultima explosao vista vem dos snapshots
+    Shader* gpuUpdateShader;
+    Shader* gpuParticleShader;
+    GpuParticles* explosion;
+    GpuParticles* dust;
+    unsigned levelClears;
+    uint64_t lastClearNs;    // tempo da simulacao do ultimo nivel limpo
+    mutable uint64_t gpuParticleTimeNs;
+    mutable unsigned explodedClears;
+    bool keyDown[1024];
+    uint64_t simTimeNs;
+    float renderAlpha;
+    glm::vec3 prevBallPosition;
+    glm::vec3 prevPaddlePosition;
     Model3D* arcadeModel;
 
     unsigned int score;
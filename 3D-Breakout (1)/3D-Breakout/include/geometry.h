@@ -0,0 +1,20 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Geometria gerada em CPU, separada do upload para o GL
+class Geometry {
+public:
+    // Esfera UV em triangulos soltos, layout posicao(3) normal(3)
+    static void buildSphere(float radius, int sectors, int stacks, std::vector<float>& out);
+
+    // Matriz model dos objectos do tabuleiro (paddle, bola, tijolos): base * T(position) * S(scale)
+    static glm::mat4 boardModelMatrix(const glm::mat4& base, const glm::vec3& position, const glm::vec3& scale) {
+        return glm::scale(glm::translate(base, position), scale);
+    }
+};
+
+#endif
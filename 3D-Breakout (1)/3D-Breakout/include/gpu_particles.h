@@ -0,0 +1,62 @@
+#ifndef GPU_PARTICLES_H
+#define GPU_PARTICLES_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+// Parametros de um efeito; as unidades sao as do espaco onde e simulado
+struct GpuParticleSettings {
+    glm::vec3 spawnCenter;
+    glm::vec3 spawnExtent;
+    glm::vec3 color;
+    float speed;         // velocidade maxima ao nascer, em direccao aleatoria
+    float size;
+    float life;          // segundos (variacao de +-50%)
+    float gravity;
+    float drag;
+    float turbulence;    // deriva por um campo de senos (poeira)
+    float fadeTime;
+    bool respawn;        // fluxo continuo: as mortas renascem logo
+};
+
+// Particulas simuladas so na GPU: dois VBOs de estado em ping-pong, actualizados por
+// transform feedback (GL 3.3) e desenhados como pontos a partir do mesmo buffer. O CPU
+// so muda uniforms; nao ha copias nem leituras de volta, seja qual for a capacidade
+class GpuParticles {
+public:
+    GpuParticleSettings settings;
+
+    GpuParticles(size_t capacity, const GpuParticleSettings& settings);
+    ~GpuParticles();
+    GpuParticles(const GpuParticles&) = delete;
+    GpuParticles& operator=(const GpuParticles&) = delete;
+
+    // Faz nascer count particulas (as mais antigas do anel) no proximo simulate()
+    void burst(size_t count);
+    // Um passo de transform feedback com o programa de particle_update.vert
+    void simulate(Shader& update, float dt);
+    // space leva o espaco da simulacao ao mundo; viewportHeight da o tamanho dos pontos
+    void draw(Shader& render, const glm::mat4& space, const glm::mat4& view, const glm::mat4& projection, unsigned viewportHeight) const;
+
+    size_t capacity() const { return slots; }
+
+    // Nomes das saidas de particle_update.vert, pela ordem do buffer
+    static const char* const FEEDBACK_VARYINGS[2];
+
+private:
+    GLuint buffers[2];
+    GLuint vaos[2];          // vao[i] le buffers[i]: serve a simulacao e o desenho
+    unsigned current;        // buffer com o estado mais recente
+    size_t slots;
+    size_t spawnCursor;
+    size_t pendingSpawn;
+    float time;
+    uint32_t seed;
+    bool active;             // ha (ou pode haver) particulas vivas
+};
+
+#endif
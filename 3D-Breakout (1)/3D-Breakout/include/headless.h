@@ -0,0 +1,39 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <GL/glew.h>
+
+// Contexto OpenGL 3.3 core sem janela (EGL surfaceless, p.ex. Mesa llvmpipe) para
+// correr o benchmark em maquinas de CI sem display nem GPU. O jogo desenha num FBO
+// com a resolucao pedida em vez do backbuffer da janela.
+// So disponivel com -DBREAKOUT_HEADLESS (Linux, -lEGL); sem isso create() falha sempre.
+class HeadlessContext {
+public:
+    HeadlessContext() : width(0), height(0), fbo(0), colorRbo(0), depthRbo(0), display(nullptr), context(nullptr) {}
+    ~HeadlessContext() { destroy(); }
+
+    // Cria e torna corrente o contexto EGL
+    bool create(int width, int height);
+    // Cria o FBO de destino; precisa das funcoes GL ja carregadas (depois do glewInit)
+    bool createFramebuffer();
+    void destroy();
+
+    // Liga/desliga o contexto na thread actual (--threaded passa-o para a thread de render)
+    bool makeCurrent(bool current);
+
+    // Substitui o glfwSwapBuffers: sem swapchain espera-se pelo fim do frame
+    // para que o tempo medido inclua todo o trabalho da GPU
+    void present();
+
+    // Aceita "1280x720"
+    static bool parseResolution(const char* text, int& width, int& height);
+
+    int width, height;
+
+private:
+    GLuint fbo, colorRbo, depthRbo;
+    void* display;
+    void* context;
+};
+
+#endif
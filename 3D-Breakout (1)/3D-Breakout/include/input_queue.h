@@ -0,0 +1,56 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Evento de teclado com o instante (relogio do Trace, ns) em que o GLFW o entregou.
+// Tambem e o formato natural para gravar e repetir partidas
+struct InputEvent {
+    uint64_t timeNs;
+    int key;
+    int action;    // GLFW_PRESS / GLFW_RELEASE
+};
+
+// Fila lock-free de um produtor e um consumidor. Capacity tem de ser potencia de 2.
+// head e tail ficam em linhas de cache separadas para o produtor e o consumidor nao
+// invalidarem a linha um do outro a cada evento
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Produtor. Devolve false com a fila cheia (o evento perde-se)
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumidor: olha para o proximo sem o retirar
+    const T* peek() const {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return nullptr;
+        return &items[h & (Capacity - 1)];
+    }
+
+    void pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) T items[Capacity];
+};
+
+typedef SpscQueue<InputEvent, 1024> InputQueue;
+
+#endif
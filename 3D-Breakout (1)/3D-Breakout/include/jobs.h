@@ -0,0 +1,179 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class JobCounter;
+
+typedef void (*JobFunction)(void* data, size_t begin, size_t end);
+
+// Um job e um intervalo [begin, end) de trabalho. O sistema nao copia nem aloca jobs:
+// a memoria e de quem submete e tem de viver ate ao wait() do contador
+struct Job {
+    JobFunction fn;
+    void* data;
+    size_t begin, end;
+    JobCounter* counter;
+};
+
+// Conta os jobs por acabar de um grupo. Pode ter continuacoes (runAfter), submetidas
+// quando chega a zero. So pode ser destruido depois de JobSystem::wait
+class JobCounter {
+public:
+    JobCounter() : pending(0) {}
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending;
+    std::mutex lock;
+    std::vector<Job*> continuations;
+};
+
+// Deque de Chase-Lev (versao de Le et al. para C11) de capacidade fixa: o dono faz push/pop
+// no fundo sem locks, os outros roubam do topo com um CAS
+class JobDeque {
+public:
+    static const int64_t CAPACITY = 1024;
+
+    JobDeque() : top(0), bottom(0) {
+        for (auto& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // So o dono. false com o deque cheio
+    bool push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= CAPACITY) return false;
+        // release no proprio slot: quem roubar ve o Job preenchido
+        slots[b & (CAPACITY - 1)].store(job, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // So o dono (LIFO: o ultimo submetido ainda esta na cache)
+    Job* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = slots[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Ultimo elemento: disputa-se com os ladroes
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Qualquer thread (FIFO)
+    Job* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = slots[t & (CAPACITY - 1)].load(std::memory_order_acquire);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    alignas(64) std::atomic<Job*> slots[CAPACITY];
+};
+
+// Threads fixas, cada uma com o seu deque; quem fica sem trabalho rouba a um vizinho
+// aleatorio. A thread que cria o sistema tem tambem um deque e ajuda em wait(); outras
+// threads (p.ex. a de render) podem submeter e esperar atraves de uma fila com lock
+class JobSystem {
+public:
+    static const unsigned MAX_PARALLEL_JOBS = 64;    // partes de um parallelFor (ficam na stack)
+
+    explicit JobSystem(unsigned workerThreads = defaultWorkers());
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static unsigned defaultWorkers();     // hardware_concurrency - 1 (a thread principal tambem trabalha)
+    unsigned concurrency() const { return (unsigned)workers.size() + 1; }
+
+    void run(Job& job, JobCounter& counter);
+    // job so e submetido quando dependency chegar a zero
+    void runAfter(JobCounter& dependency, Job& job, JobCounter& counter);
+    // Executa jobs (deste ou de outros grupos) ate o contador chegar a zero
+    void wait(JobCounter& counter);
+
+    // fn(begin, end) sobre [0, count) em partes de pelo menos grain elementos; bloqueia ate ao fim
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        size_t parts = std::min<size_t>({ (count + grain - 1) / std::max<size_t>(grain, 1), MAX_PARALLEL_JOBS, (size_t)concurrency() * 4 });
+        if (parts <= 1) { fn((size_t)0, count); return; }
+
+        typedef typename std::remove_reference<Fn>::type Body;
+        Job parallelJobs[MAX_PARALLEL_JOBS];
+        JobCounter counter;
+        for (size_t p = 0; p < parts; p++) {
+            Job& job = parallelJobs[p];
+            job.fn = [](void* data, size_t begin, size_t end) { (*static_cast<Body*>(data))(begin, end); };
+            job.data = const_cast<void*>(static_cast<const void*>(&fn));
+            job.begin = count * p / parts;
+            job.end = count * (p + 1) / parts;
+        }
+        // A primeira parte corre ja nesta thread
+        for (size_t p = 1; p < parts; p++) run(parallelJobs[p], counter);
+        fn(parallelJobs[0].begin, parallelJobs[0].end);
+        wait(counter);
+    }
+
+private:
+    struct Worker {
+        JobDeque deque;
+        uint32_t rng;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<Worker*> queues;          // 0 = thread que criou o sistema, 1.. = workers
+    std::thread::id owner;
+
+    std::mutex externalLock;              // jobs submetidos por outras threads
+    std::deque<Job*> external;
+    std::atomic<int> externalCount;
+
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<int> sleeping;
+    int wakeSignals;
+    bool quit;
+
+    int currentQueue() const;             // -1 para threads de fora
+    void submit(Job* job);
+    Job* findJob(int self);
+    void execute(Job* job);
+    void finish(JobCounter& counter);
+    void notify();
+    void workerLoop(int index);
+};
+
+// Sistema global, criado no primeiro uso (a thread que o cria passa a ser a "principal")
+JobSystem& jobs();
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const int LATENCY_QUERY_FRAMES = 4;    // GL_TIMESTAMP depois do swap, lidos sem stall alguns frames depois
+
+struct LatencyStats {
+    float median;
+    float p99;
+    float max;
+    size_t count;
+};
+
+// Latencia input -> foton: cada evento de input fica associado ao frame que o leu
+// (sampleInput) e esse frame ao GL_TIMESTAMP emitido logo depois do seu swap, que
+// marca o fim do frame na GPU. Com vsync a imagem aparece no vblank seguinte; nao ha
+// forma portavel de medir o scanout, por isso este e o instante usado como "foton".
+// Os eventos GLFW so recebem o instante em que o glfwPollEvents os entrega, nao o do SO.
+class LatencyTracker {
+public:
+    // Modo de baixa latencia (--low-latency): glFinish depois do swap (no maximo um frame
+    // em fila) e amostragem tardia do input, dormindo ate pouco antes do prazo do vblank
+    bool lowLatency;
+
+    LatencyTracker();
+
+    void init();        // cria as queries GL; precisa de contexto
+    void shutdown();
+
+    void onInput();                         // callbacks GLFW
+    void injectSyntheticInput();            // benchmark: um evento por frame, em instante aleatorio desde a ultima leitura
+    // O jogo leu o input para a simulacao deste frame; devolve o evento mais antigo (0 se
+    // nenhum) e o instante da leitura, que viajam com o snapshot ate ao render
+    void sampleInput(uint64_t& inputNs, uint64_t& sampleNs);
+    void onFrameInput(uint64_t inputNs, uint64_t sampleNs);    // render: o frame actual usou esse input
+    void beforeSwap();                      // fim do trabalho de render do frame (estimativa do prazo)
+    void onPresent();                       // logo depois do SwapBuffers (e do glFinish, no modo de baixa latencia)
+    void collect(int64_t gpuToCpuNs);       // le as queries prontas; no inicio do frame
+
+    // Modo de baixa latencia com vsync: dorme ate (proximo vblank - trabalho estimado do frame)
+    void waitForInputDeadline(double refreshHz);
+
+    LatencyStats stats(size_t lastN = 0) const;    // lastN = 0 usa todas as amostras
+    void resetSamples();
+    void printReport() const;
+
+private:
+    GLuint queries[LATENCY_QUERY_FRAMES];
+    GLuint renderQueries[LATENCY_QUERY_FRAMES];
+    uint64_t queryInputNs[LATENCY_QUERY_FRAMES];
+    uint64_t querySampleNs[LATENCY_QUERY_FRAMES];
+    bool queryIssued[LATENCY_QUERY_FRAMES];
+    unsigned slot;
+    bool ready;
+
+    // Lado da simulacao (callbacks GLFW e leitura do input)
+    uint64_t pendingInputNs;    // evento mais antigo ainda nao lido pelo jogo
+    uint64_t lastSampleNs;
+
+    // Lado do render
+    uint64_t frameInputNs;      // evento mais antigo lido pela simulacao deste frame
+    uint64_t sampleNs;          // instante da leitura do input deste frame
+    uint64_t lastPresentNs;
+    float workEstimateMs;       // leitura do input -> fim do render na GPU, antes do swap (media movel)
+    uint32_t rng;
+
+    std::vector<float> samples;
+};
+
+LatencyTracker& latency();
+
+#endif
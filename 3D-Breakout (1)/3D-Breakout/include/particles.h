@@ -0,0 +1,65 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Uma instancia do draw instanciado: centro e tamanho, cor e alpha
+struct ParticleInstance {
+    glm::vec4 positionSize;
+    glm::vec4 color;
+};
+
+// Rajada de particulas a partir de uma caixa do tabuleiro (p.ex. um tijolo partido)
+struct ParticleBurst {
+    glm::vec3 center;
+    glm::vec3 extent;
+    glm::vec3 color;
+    unsigned count;
+    float speed;    // velocidade maxima, em direccao aleatoria
+    float size;
+    float life;     // segundos (variacao de +-50%)
+};
+
+// Pool de capacidade fixa em SoA: um array por campo, alinhado a 16 bytes, actualizado
+// com SSE2 quatro particulas de cada vez. Os lugares das que morrem vao para uma lista
+// livre e sao reutilizados; sem alocacoes depois do construtor
+class ParticlePool {
+public:
+    static const size_t DEFAULT_CAPACITY = 65536;
+
+    explicit ParticlePool(size_t capacity = DEFAULT_CAPACITY);
+    ~ParticlePool();
+    ParticlePool(const ParticlePool&) = delete;
+    ParticlePool& operator=(const ParticlePool&) = delete;
+
+    // Devolve quantas couberam (o resto da rajada e descartado com a pool cheia)
+    unsigned emit(const ParticleBurst& burst);
+    // Gravidade em -Y do tabuleiro e atrito do ar
+    void update(float dt, float gravity, float drag);
+    void clear();
+
+    // Copia as vivas para o snapshot de render (out deve ter capacidade para capacity())
+    void pack(std::vector<ParticleInstance>& out) const;
+
+    size_t alive() const { return aliveCount; }
+    size_t capacity() const { return slots; }
+
+private:
+    enum Field { PX, PY, PZ, VX, VY, VZ, LIFE, FADE, R, G, B, SIZE, FIELD_COUNT };
+
+    float* fields[FIELD_COUNT];    // vida <= 0 = lugar livre
+    float* block;
+    uint32_t* freeSlots;
+    size_t freeCount;
+    size_t slots;
+    size_t highWater;              // lugares [0, highWater) ja usados desde o ultimo esvaziar
+    size_t aliveCount;
+    uint32_t rng;
+
+    float random();                // [0, 1)
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <GL/glew.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+enum ProfileScopeId {
+    PROFILE_FRAME,
+    PROFILE_INPUT,
+    PROFILE_UPDATE,
+    PROFILE_COLLISION,
+    PROFILE_SCENE_RENDER,
+    PROFILE_IMGUI_BUILD,
+    PROFILE_IMGUI_RENDER,
+    PROFILE_SWAP,
+    PROFILE_SCOPE_COUNT
+};
+
+enum GpuPassId {
+    GPU_SCENE,
+    GPU_IMGUI,
+    GPU_PASS_COUNT
+};
+
+const int PROFILE_WINDOW = 240;    // amostras (frames) usadas para min/avg/p99
+const int GPU_QUERY_FRAMES = 2;    // queries em double-buffer: le-se o frame anterior, sem stall
+
+// Frustum culling das meshes do modelo (Model3D::render), por frame
+struct CullCounts {
+    unsigned meshesDrawn;
+    unsigned meshesCulled;
+    unsigned clustersDrawn;
+    unsigned clustersCulled;       // fora do frustum
+    unsigned clustersBackfacing;   // rejeitados pelo cone das normais
+};
+
+struct ProfileStats {
+    float min;
+    float avg;
+    float p99;
+};
+
+class RollingSamples {
+public:
+    RollingSamples() : count(0), next(0) { samples.fill(0.0f); }
+    void add(float ms);
+    ProfileStats stats() const;
+    float last() const { return count ? samples[(next + PROFILE_WINDOW - 1) % PROFILE_WINDOW] : 0.0f; }
+
+private:
+    std::array<float, PROFILE_WINDOW> samples;
+    int count;
+    int next;
+};
+
+class Profiler {
+public:
+    std::atomic<bool> visible;    // alterado no callback de teclado, lido pela thread de render
+
+    // Contadores do frame actual (GL_TRIANGLES); last* guardam o frame anterior completo
+    unsigned drawCalls;
+    unsigned long long triangles;
+    unsigned lastDrawCalls;
+    unsigned long long lastTriangles;
+
+    void countDraw(unsigned vertexCount, unsigned instances = 1) {
+        drawCalls++;
+        triangles += (unsigned long long)(vertexCount / 3) * instances;
+    }
+
+    CullCounts culling;
+    CullCounts lastCulling;
+
+    // Uma mesh testada: desenhada (com os clusters que passaram) ou cortada inteira
+    void countCulling(bool meshDrawn, unsigned clustersDrawn, unsigned clustersCulled, unsigned clustersBackfacing = 0) {
+        if (meshDrawn) culling.meshesDrawn++;
+        else culling.meshesCulled++;
+        culling.clustersDrawn += clustersDrawn;
+        culling.clustersCulled += clustersCulled;
+        culling.clustersBackfacing += clustersBackfacing;
+    }
+
+    Profiler();
+
+    void init();        // cria as queries GL; precisa de contexto
+    void shutdown();
+
+    void beginFrame();
+    void endFrame();
+
+    void beginCpu(ProfileScopeId id);
+    void endCpu(ProfileScopeId id);
+    void beginGpu(GpuPassId pass);
+    void endGpu(GpuPassId pass);
+
+    const RollingSamples& cpu(ProfileScopeId id) const { return cpuSamples[id]; }
+    // operator new dentro do scope no ultimo frame completo (inclui os scopes aninhados)
+    uint64_t allocations(ProfileScopeId id) const { return lastAllocs[id]; }
+    const RollingSamples& gpu(GpuPassId pass) const { return gpuSamples[pass]; }
+    int64_t gpuClockOffsetNs() const { return gpuToCpuNs; }
+
+    void renderOverlay();
+
+    // --alloc-audit: depois de endFrame, nos frames em que estes scopes nao podem alocar.
+    // A primeira falha de cada scope e escrita logo, com o nome do scope
+    void auditAllocations(const ProfileScopeId* scopes, int count);
+    bool printAllocAudit() const;    // false se algum scope alocou ou nenhum frame foi auditado
+
+private:
+    // Os scopes da simulacao podem correr noutra thread (--threaded): somam aqui e o
+    // frame de render que estiver a decorrer leva-os em endFrame
+    std::array<std::atomic<uint64_t>, PROFILE_SCOPE_COUNT> cpuAccumNs;
+    std::array<RollingSamples, PROFILE_SCOPE_COUNT> cpuSamples;
+    std::array<std::atomic<uint64_t>, PROFILE_SCOPE_COUNT> allocAccum;
+    std::array<uint64_t, PROFILE_SCOPE_COUNT> lastAllocs;
+    std::array<uint64_t, PROFILE_SCOPE_COUNT> auditAllocs;
+    std::array<unsigned, PROFILE_SCOPE_COUNT> auditFrames;    // frames auditados em que o scope alocou
+    unsigned auditedFrames;
+
+    GLuint queries[GPU_QUERY_FRAMES][GPU_PASS_COUNT];
+    GLuint stamps[GPU_QUERY_FRAMES][GPU_PASS_COUNT];    // GL_TIMESTAMP no inicio de cada pass, para o trace
+    bool queryIssued[GPU_QUERY_FRAMES][GPU_PASS_COUNT];
+    std::array<RollingSamples, GPU_PASS_COUNT> gpuSamples;
+    unsigned frameIndex;
+    bool gpuReady;
+    int64_t gpuToCpuNs;    // relogio GPU -> relogio do Trace, recalibrado a cada frame
+};
+
+Profiler& profiler();
+
+// Mede o bloco actual no CPU; o mesmo id pode ser aberto varias vezes por frame (soma).
+// Cada scope fica tambem registado no Trace
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileScopeId id) : id(id) { profiler().beginCpu(id); }
+    ~ProfileScope() { profiler().endCpu(id); }
+private:
+    ProfileScopeId id;
+};
+
+// GL_TIME_ELAPSED a volta de um pass; nao pode haver dois passes GPU aninhados
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(GpuPassId pass) : pass(pass) { profiler().beginGpu(pass); }
+    ~GpuProfileScope() { profiler().endGpu(pass); }
+private:
+    GpuPassId pass;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(id) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(id)
+#define PROFILE_GPU(pass) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(pass)
+
+#endif
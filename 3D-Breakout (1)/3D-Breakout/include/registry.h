@@ -0,0 +1,182 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Entidade = indice (24 bits de baixo) + geracao (8 bits de cima). A geracao muda quando o
+// indice e reutilizado, por isso um handle antigo deixa de ser valido. O indice 0xFFFFFF fica
+// reservado: com a geracao 255 seria igual a NULL_ENTITY
+typedef uint32_t Entity;
+const Entity NULL_ENTITY = 0xFFFFFFFFu;
+const uint32_t ENTITY_INDEX_BITS = 24;
+const uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const uint32_t ENTITY_MAX_COUNT = ENTITY_INDEX_MASK;    // indices 0 .. 0xFFFFFE
+
+inline uint32_t entityIndex(Entity e) { return e & ENTITY_INDEX_MASK; }
+inline uint32_t entityGeneration(Entity e) { return e >> ENTITY_INDEX_BITS; }
+
+// Sparse set: sparse[indice] da a posicao no array denso. Os componentes de um tipo ficam
+// contiguos e remover troca com o ultimo, por isso a ordem densa muda ao destruir
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase() {}
+    virtual void remove(Entity e) = 0;
+    virtual void clear() = 0;
+
+    bool has(Entity e) const {
+        uint32_t index = entityIndex(e);
+        return index < sparse.size() && sparse[index] != EMPTY && dense[sparse[index]] == e;
+    }
+    size_t size() const { return dense.size(); }
+    const Entity* entities() const { return dense.data(); }
+
+protected:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    std::vector<uint32_t> sparse;
+    std::vector<Entity> dense;
+
+    uint32_t insertSlot(Entity e) {
+        uint32_t index = entityIndex(e);
+        if (index >= sparse.size()) sparse.resize(index + 1, EMPTY);
+        sparse[index] = (uint32_t)dense.size();
+        dense.push_back(e);
+        return sparse[index];
+    }
+
+    // Tira e de dense trocando com o ultimo; devolve a posicao que ficou livre
+    uint32_t eraseSlot(Entity e) {
+        uint32_t slot = sparse[entityIndex(e)];
+        Entity last = dense.back();
+        dense[slot] = last;
+        sparse[entityIndex(last)] = slot;
+        dense.pop_back();
+        sparse[entityIndex(e)] = EMPTY;
+        return slot;
+    }
+
+    void clearSlots() {
+        for (Entity e : dense) sparse[entityIndex(e)] = EMPTY;
+        dense.clear();
+    }
+};
+
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    T& add(Entity e, const T& value) {
+        if (has(e)) return components[sparse[entityIndex(e)]] = value;
+        insertSlot(e);
+        components.push_back(value);
+        return components.back();
+    }
+
+    void remove(Entity e) override {
+        if (!has(e)) return;
+        uint32_t slot = eraseSlot(e);
+        components[slot] = std::move(components.back());
+        components.pop_back();
+    }
+
+    void clear() override {
+        clearSlots();
+        components.clear();
+    }
+
+    void reserve(size_t count) {
+        dense.reserve(count);
+        components.reserve(count);
+    }
+
+    T& get(Entity e) { return components[sparse[entityIndex(e)]]; }
+    const T& get(Entity e) const { return components[sparse[entityIndex(e)]]; }
+    T* find(Entity e) { return has(e) ? &get(e) : nullptr; }
+    const T* find(Entity e) const { return has(e) ? &get(e) : nullptr; }
+
+    // Acesso denso, na mesma ordem de entities()
+    T* data() { return components.data(); }
+    const T* data() const { return components.data(); }
+
+private:
+    std::vector<T> components;
+};
+
+// Entidades e um pool por tipo de componente, criado no primeiro uso. Os sistemas percorrem
+// os arrays densos (pool<T>().data()) em vez de seguir ponteiros objecto a objecto
+class Registry {
+public:
+    Registry() : aliveCount(0) {}
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    Entity create();
+    // Tira a entidade de todos os pools. Nao aloca: o indice volta para uma lista ja reservada
+    void destroy(Entity e);
+    bool valid(Entity e) const;
+    // Destroi todas as entidades; os pools e as listas mantem a capacidade
+    void clear();
+    size_t size() const { return aliveCount; }
+
+    template <typename T>
+    ComponentPool<T>& pool() {
+        size_t id = componentId<T>();
+        if (id >= pools.size()) pools.resize(id + 1);
+        if (!pools[id]) pools[id].reset(new ComponentPool<T>());
+        return *static_cast<ComponentPool<T>*>(pools[id].get());
+    }
+
+    // nullptr se o tipo ainda nao foi usado
+    template <typename T>
+    const ComponentPool<T>* findPool() const {
+        size_t id = componentId<T>();
+        return id < pools.size() ? static_cast<const ComponentPool<T>*>(pools[id].get()) : nullptr;
+    }
+
+    template <typename T>
+    T& add(Entity e, const T& value) { return pool<T>().add(e, value); }
+    template <typename T>
+    void remove(Entity e) { pool<T>().remove(e); }
+    template <typename T>
+    bool has(Entity e) const { const ComponentPool<T>* p = findPool<T>(); return p && p->has(e); }
+    template <typename T>
+    T& get(Entity e) { return pool<T>().get(e); }
+
+    // fn(entidade, a, b) para cada entidade com A e B, pela ordem densa de A. Pools que
+    // recebem e perdem componentes das mesmas entidades ficam alinhados e B tambem e lido
+    // em sequencia; so quando a posicao nao bate se consulta o sparse de B
+    template <typename A, typename B, typename Fn>
+    void each(Fn fn) { eachOf(&pool<A>(), &pool<B>(), fn); }
+    template <typename A, typename B, typename Fn>
+    void each(Fn fn) const { eachOf(findPool<A>(), findPool<B>(), fn); }
+
+private:
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeIndices;    // capacidade >= generations.size()
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools;
+    size_t aliveCount;
+
+    static size_t nextComponentId();
+    template <typename T>
+    static size_t componentId() {
+        static const size_t id = nextComponentId();
+        return id;
+    }
+
+    template <typename PoolA, typename PoolB, typename Fn>
+    static void eachOf(PoolA* a, PoolB* b, Fn& fn) {
+        if (!a || !b) return;
+        const Entity* entities = a->entities();
+        const Entity* others = b->entities();
+        size_t count = a->size(), otherCount = b->size();
+        for (size_t i = 0; i < count; i++) {
+            Entity e = entities[i];
+            if (i < otherCount && others[i] == e) fn(e, a->data()[i], b->data()[i]);
+            else if (auto* other = b->find(e)) fn(e, a->data()[i], *other);
+        }
+    }
+};
+
+#endif
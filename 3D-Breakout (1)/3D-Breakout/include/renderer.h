@@ -2,6 +2,7 @@
 #define RENDERER_H
 
 #include <GL/glew.h>
+#include <cstddef>
 #include <vector>
 
 class Renderer {
@@ -9,19 +10,32 @@ public:
     GLuint cubeVAO;
     GLuint sphereVAO;
     int sphereVertexCount;
+    // Cubo instanciado das particulas: atributos 2 (centro, tamanho) e 3 (cor, alpha) por instancia
+    GLuint particleVAO;
+    GLuint particleInstanceVBO;
+    size_t particleCapacity;
+    // Impostores de esferas: quad (strip de 4 cantos) por instancia, atributo 1 = centro e raio
+    GLuint impostorVAO;
+    GLuint impostorInstanceVBO;
+    size_t impostorCapacity;
     
     Renderer();
     ~Renderer();
     
     void init();
     void cleanup();
+    // Garante espaco para count impostores (realoca so o buffer GL, sem tocar no heap)
+    void reserveImpostors(size_t count);
     
 private:
     GLuint cubeVBO;
     GLuint sphereVBO;
+    GLuint impostorQuadVBO;
     
     void createCube();
     void createSphere(float radius, int sectors, int stacks);
+    void createParticles(size_t maxInstances);
+    void createImpostors(size_t maxInstances);
 };
 
 #endif
\ No newline at end of file
@@ -14,9 +14,20 @@ public:
     GLuint ID;
     
     Shader(const char* vertexPath, const char* fragmentPath);
+    // Programa de transform feedback: as saidas indicadas do vertex shader sao gravadas num
+    // buffer (intercaladas, pela ordem dada). fragmentPath pode ser nullptr se so se simula
+    Shader(const char* vertexPath, const char* fragmentPath, const char* const* feedbackVaryings, int feedbackCount);
     
     void use();
     
+    // Versoes const char*: os literais escolhem estas e nao constroem uma std::string por uniform
+    void setBool(const char* name, bool value) const;
+    void setInt(const char* name, int value) const;
+    void setFloat(const char* name, float value) const;
+    void setVec3(const char* name, const glm::vec3 &value) const;
+    void setVec3(const char* name, float x, float y, float z) const;
+    void setMat4(const char* name, const glm::mat4 &mat) const;
+    
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
@@ -25,6 +36,8 @@ public:
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
     
 private:
+    void build(const char* vertexPath, const char* fragmentPath, const char* const* feedbackVaryings, int feedbackCount);
+    GLuint compile(const char* path, GLenum type, const char* typeName);
     void checkCompileErrors(GLuint shader, std::string type);
 };
 
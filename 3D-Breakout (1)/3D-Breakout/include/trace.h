@@ -0,0 +1,96 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+const uint32_t TRACE_RING_CAPACITY = 1 << 16;    // eventos por thread (potencia de 2)
+const uint32_t TRACE_GPU_TID = 0xFFFF;           // "thread" virtual para os passes GPU
+
+struct TraceEvent {
+    const char* name;     // tem de ser uma string estatica
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t tid;
+};
+
+// Ring buffer de uma thread: so a propria thread escreve (sem locks); quem exporta valida
+// cada slot pelo numero de sequencia (seqlock). O evento e guardado em palavras atomicas
+// relaxed para a leitura concorrente com a escrita nao ser uma data race
+struct TraceRing {
+    static const size_t EVENT_WORDS = sizeof(TraceEvent) / sizeof(uint64_t);
+    static_assert(sizeof(TraceEvent) == EVENT_WORDS * sizeof(uint64_t), "TraceEvent must be a whole number of words");
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<uint64_t> words[EVENT_WORDS];
+
+        // Copia o evento; false se o escritor mexeu no slot durante a copia ou se nao e o evento 'expected'
+        bool read(uint64_t expected, TraceEvent& out) const {
+            if (seq.load(std::memory_order_acquire) != expected) return false;
+            uint64_t copy[EVENT_WORDS];
+            for (size_t w = 0; w < EVENT_WORDS; w++) copy[w] = words[w].load(std::memory_order_relaxed);
+            // As palavras lidas acima ficam ordenadas antes da segunda leitura de seq
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) != expected) return false;
+            std::memcpy(&out, copy, sizeof(out));
+            return true;
+        }
+    };
+
+    Slot slots[TRACE_RING_CAPACITY];
+    std::atomic<uint64_t> head;
+    uint32_t tid;
+    std::atomic<const char*> threadName;    // setThreadName() pode correr durante um dump
+
+    TraceRing() : head(0), tid(0), threadName("thread") {
+        for (auto& slot : slots) {
+            slot.seq.store(0, std::memory_order_relaxed);
+            for (auto& word : slot.words) word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void push(const TraceEvent& event) {
+        uint64_t index = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[index & (TRACE_RING_CAPACITY - 1)];
+        uint64_t copy[EVENT_WORDS];
+        std::memcpy(copy, &event, sizeof(event));
+        slot.seq.store(0, std::memory_order_relaxed);
+        // O 0 em seq fica visivel antes de qualquer palavra nova
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t w = 0; w < EVENT_WORDS; w++) slot.words[w].store(copy[w], std::memory_order_relaxed);
+        slot.seq.store(index + 1, std::memory_order_release);
+        head.store(index + 1, std::memory_order_release);
+    }
+};
+
+class Trace {
+public:
+    static bool enabled;
+
+    static uint64_t nowNs();
+    static void setThreadName(const char* name);
+
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+    static void recordGpu(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // Escreve os ultimos 'lastSeconds' em formato Chrome trace-event (chrome://tracing, Perfetto)
+    static bool dump(const std::string& path, double lastSeconds);
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start(Trace::nowNs()) {}
+    ~TraceScope() { Trace::record(name, start, Trace::nowNs()); }
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// Caixa de correio de tres slots entre um produtor e um consumidor. O produtor escreve
+// num slot so seu e publica-o trocando-o com o do meio; o consumidor troca o seu pelo
+// do meio quando ha um novo. As trocas sao uma so operacao atomica e nenhum dos lados
+// copia dados nem fica a espera do outro para escrever/ler; as esperas com condition
+// variable so servem para uma thread dormir quando nao ha trabalho
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(0), front(2), closed(false) {}
+
+    // Produtor
+    T& writeSlot() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+        wake();
+    }
+
+    // Espera que o consumidor leve o ultimo publicado; false depois de close()
+    bool waitConsumed() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this] { return closed || !(middle.load(std::memory_order_acquire) & FRESH); });
+        return !closed;
+    }
+
+    // Consumidor
+    const T& readSlot() const { return slots[front]; }
+
+    // Passa a ler o ultimo publicado; false se nao ha nenhum novo
+    bool acquire() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        wake();
+        return true;
+    }
+
+    // Espera por um publicado novo; false se foi fechado sem nenhum pendente
+    bool waitFresh() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this] { return closed || (middle.load(std::memory_order_acquire) & FRESH); });
+        return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    // Qualquer um dos lados: acorda o outro e faz falhar as esperas seguintes
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        cond.notify_all();
+    }
+
+private:
+    static const unsigned INDEX = 3;
+    static const unsigned FRESH = 4;
+
+    // O lock vazio ordena a troca com o teste do predicado de quem vai dormir
+    void wake() {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        cond.notify_all();
+    }
+
+    T slots[3];
+    std::atomic<unsigned> middle;    // indice do slot do meio | FRESH
+    unsigned back, front;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool closed;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef VFS_H
+#define VFS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato do arquivo .pak:
+//   PakHeader | PakEntry[entryCount] (cada um seguido do nome) | dados (alinhados a 16 bytes)
+const char PAK_MAGIC[4] = { 'B', 'K', 'P', 'K' };
+const uint32_t PAK_VERSION = 1;
+const uint32_t PAK_FLAG_LZ4 = 1;
+
+struct PakHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t tocBytes;
+};
+
+struct PakEntry {
+    uint64_t offset;
+    uint64_t storedSize;
+    uint64_t rawSize;
+    uint32_t flags;
+    uint32_t nameLength;
+};
+
+// Conteudo de um asset. Entradas nao comprimidas do arquivo apontam directamente
+// para a memoria mapeada; o resto (LZ4, ficheiros soltos) fica num buffer proprio
+class VfsFile {
+public:
+    VfsFile() : ptr(nullptr), length(0) {}
+    VfsFile(const VfsFile&) = delete;
+    VfsFile& operator=(const VfsFile&) = delete;
+    VfsFile(VfsFile&&) = default;
+    VfsFile& operator=(VfsFile&&) = default;
+
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+    bool isMapped() const { return ptr != nullptr && owned.empty(); }
+
+private:
+    friend class Vfs;
+    const char* ptr;
+    size_t length;
+    std::vector<char> owned;
+};
+
+class Vfs {
+public:
+    // Mapeia o arquivo uma vez; sem arquivo montado tudo e lido de ficheiros soltos
+    static bool mount(const std::string& archivePath);
+    static void unmount();
+    static bool isMounted();
+
+    static bool exists(const std::string& path);
+    static bool read(const std::string& path, VfsFile& out);
+    static bool readText(const std::string& path, std::string& out);
+
+    static std::string normalize(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,19 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec4 aPositionSize;   // por instancia: centro no tabuleiro e tamanho
+layout (location = 3) in vec4 aColor;          // por instancia: alpha = vida que resta
+
+out vec4 Color;
+
+uniform mat4 board;       // plano do tabuleiro -> mundo
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+    vec3 local = aPositionSize.xyz + aPos * aPositionSize.w;
+    // Luz fixa de frente, so para as faces dos detritos se distinguirem
+    float shade = 0.6 + 0.4 * max(dot(aNormal, normalize(vec3(0.3, 0.5, 1.0))), 0.0);
+    Color = vec4(aColor.rgb * shade, aColor.a);
+    gl_Position = projection * view * board * vec4(local, 1.0);
+}
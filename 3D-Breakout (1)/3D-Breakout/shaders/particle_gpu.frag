@@ -0,0 +1,11 @@
+#version 330 core
+in vec4 Color;
+out vec4 FragColor;
+
+void main() {
+    // Ponto redondo e macio
+    vec2 d = gl_PointCoord * 2.0 - 1.0;
+    float r2 = dot(d, d);
+    if (r2 > 1.0) discard;
+    FragColor = vec4(Color.rgb, Color.a * (1.0 - r2));
+}
@@ -0,0 +1,28 @@
+#version 330 core
+// Desenho das particulas GPU directamente do buffer de estado, como pontos
+layout (location = 0) in vec4 aPositionLife;
+layout (location = 1) in vec4 aVelocitySize;
+
+out vec4 Color;
+
+uniform mat4 space;          // espaco da simulacao -> mundo (tabuleiro ou sala)
+uniform mat4 view;
+uniform mat4 projection;
+uniform float pointScale;    // altura do viewport * projection[1][1] / 2, ja com a escala de space
+uniform float fadeTime;      // segundos finais em que a particula desvanece
+uniform vec3 color;
+
+void main() {
+    if (aPositionLife.w <= 0.0) {
+        // Morta: fora do volume de recorte, nao chega a ser rasterizada
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = 0.0;
+        Color = vec4(0.0);
+        return;
+    }
+    gl_Position = projection * view * space * vec4(aPositionLife.xyz, 1.0);
+    gl_PointSize = max(aVelocitySize.w * pointScale / gl_Position.w, 1.0);
+    // Nasce quente (quase branca) e arrefece para a cor do efeito
+    float heat = clamp(length(aVelocitySize.xyz) * 0.05, 0.0, 1.0);
+    Color = vec4(mix(color, vec3(1.0, 0.95, 0.85), heat * 0.6), clamp(aPositionLife.w / fadeTime, 0.0, 1.0));
+}
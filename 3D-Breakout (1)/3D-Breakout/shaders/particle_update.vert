@@ -0,0 +1,66 @@
+#version 330 core
+// Simulacao das particulas GPU: um vertice por particula, o resultado vai por transform
+// feedback para o outro buffer (sem rasterizacao)
+layout (location = 0) in vec4 aPositionLife;   // vida <= 0 = morta
+layout (location = 1) in vec4 aVelocitySize;
+
+out vec4 outPositionLife;
+out vec4 outVelocitySize;
+
+uniform float dt;
+uniform float time;
+uniform float gravity;
+uniform float drag;
+uniform float turbulence;
+uniform int capacity;
+uniform int spawnBegin;      // [spawnBegin, spawnBegin + spawnCount) em anel: nascem neste passo
+uniform int spawnCount;
+uniform bool respawn;        // as mortas renascem logo (fluxo continuo)
+uniform int seed;
+uniform vec3 spawnCenter;
+uniform vec3 spawnExtent;
+uniform float spawnSpeed;
+uniform float spawnSize;
+uniform float spawnLife;
+
+uint hash(uint x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float random(inout uint state) {
+    state = hash(state);
+    return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+void main() {
+    vec3 position = aPositionLife.xyz;
+    float life = aPositionLife.w;
+    vec3 velocity = aVelocitySize.xyz;
+    float size = aVelocitySize.w;
+
+    int ring = (gl_VertexID - spawnBegin + capacity) % capacity;
+    if (ring < spawnCount || (respawn && life <= 0.0)) {
+        uint state = uint(gl_VertexID) * 0x9e3779b9u ^ uint(seed);
+        position = spawnCenter + (vec3(random(state), random(state), random(state)) - 0.5) * spawnExtent;
+        // Direccao uniforme na esfera
+        float z = random(state) * 2.0 - 1.0;
+        float angle = random(state) * 6.2831853;
+        vec3 direction = vec3(sqrt(1.0 - z * z) * vec2(cos(angle), sin(angle)), z);
+        velocity = direction * spawnSpeed * (0.3 + 0.7 * random(state));
+        size = spawnSize * (0.5 + random(state));
+        life = spawnLife * (0.5 + random(state));
+    } else if (life > 0.0) {
+        // Deriva suave para a poeira: um campo de senos que muda com o tempo
+        velocity += turbulence * dt * vec3(sin(position.y * 1.7 + time), sin(position.z * 1.3 + time * 0.7), sin(position.x * 1.1 + time * 1.3));
+        velocity.y -= gravity * dt;
+        velocity *= max(0.0, 1.0 - drag * dt);
+        position += velocity * dt;
+        life = max(life - dt, 0.0);
+    }
+
+    outPositionLife = vec4(position, life);
+    outVelocitySize = vec4(velocity, size);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 BakedLight;
+
+uniform sampler2D texture1;
+uniform int useTexture;
+
+void main() {
+    // Sem textura a cor do material ja esta no vertice
+    vec3 baseColor = (useTexture == 1) ? texture(texture1, TexCoords).rgb : vec3(1.0);
+    FragColor = vec4(BakedLight * baseColor, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec3 aColor;
+
+out vec2 TexCoords;
+out vec3 BakedLight;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// Sala estatica: a luz ja vem cozinhada na cor do vertice (Model3D::bakeLighting)
+void main() {
+    TexCoords = aTexCoords;
+    BakedLight = aColor;
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
@@ -0,0 +1,57 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 ViewPos;
+flat in vec3 CenterView;
+flat in float Radius;
+
+uniform mat4 projection;
+uniform mat4 viewInverse;
+uniform vec3 objectColor;
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+struct MaterialData {
+    vec3 diffuse;
+    vec3 ambient;
+    vec3 specular;
+    float shininess;
+};
+uniform MaterialData material;
+
+void main() {
+    // Raio da camara (origem no espaco de vista) por este pixel contra a esfera
+    vec3 dir = normalize(ViewPos);
+    float b = dot(dir, CenterView);
+    float c = dot(CenterView, CenterView) - Radius * Radius;
+    float disc = b * b - c;
+    if (disc < 0.0) discard;
+    vec3 hit = dir * (b - sqrt(disc));
+
+    // Profundidade do ponto da esfera, nao do quad: intersecta bem com o resto da cena
+    vec4 clip = projection * vec4(hit, 1.0);
+    gl_FragDepth = (gl_DepthRange.diff * clip.z / clip.w + gl_DepthRange.near + gl_DepthRange.far) * 0.5;
+
+    vec3 FragPos = (viewInverse * vec4(hit, 1.0)).xyz;
+    vec3 norm = normalize(mat3(viewInverse) * (hit - CenterView));
+
+    // Mesmo Phong de fragment.frag, sem textura nem cor por vertice
+    vec3 ambientBase = (material.ambient != vec3(0.0)) ? material.ambient : vec3(0.2, 0.1, 0.4);
+    vec3 ambient = ambientBase * lightColor;
+
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    vec3 specularColor = (material.specular != vec3(0.0)) ? material.specular : vec3(1.0);
+    float shininess = (material.shininess > 0.0) ? material.shininess : 32.0;
+
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = 0.8 * spec * specularColor * lightColor;
+
+    vec3 baseColor = (material.diffuse != vec3(0.0)) ? material.diffuse : objectColor;
+    FragColor = vec4((ambient + diffuse + specular) * baseColor, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+// Uma esfera por instancia como um quad virado para a camara; a esfera e calculada no fragment
+layout (location = 0) in vec2 aCorner;   // -1..1
+layout (location = 1) in vec4 aSphere;   // por instancia: centro no tabuleiro e raio
+
+out vec3 ViewPos;
+flat out vec3 CenterView;
+flat out float Radius;
+
+uniform mat4 board;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float boardScale;   // escala de board, para o raio em unidades do mundo
+
+void main() {
+    CenterView = (view * board * vec4(aSphere.xyz, 1.0)).xyz;
+    Radius = aSphere.w * boardScale;
+    // Em perspectiva a silhueta passa do raio (d / sqrt(d^2 - r^2) no eixo, um pouco mais
+    // fora dele): o quad leva folga e o fragment descarta o que fica fora
+    float d2 = dot(CenterView, CenterView);
+    float grow = 1.15 * sqrt(d2 / max(d2 - Radius * Radius, 1e-6));
+    ViewPos = CenterView + vec3(aCorner * Radius * grow, 0.0);
+    gl_Position = projection * vec4(ViewPos, 1.0);
+}
@@ -9,30 +9,62 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 
-#include "common/tiny_obj_loader.h"
+#include "ObjParser.hpp"
+#include "vfs.h"
+#include "btex.h"
+#include "profiler.h"
+#include "frustum.h"
 #include "common/stb_image.h"
 
+// Triangulos consecutivos do VBO de uma mesh, espacialmente juntos (ordem de Morton), com a
+// caixa e o cone das normais para o frustum e o back-face culling por cluster
+struct MeshCluster {
+    Aabb bounds;
+    NormalCone cone;
+    GLint first;      // primeiro vertice
+    GLsizei count;    // vertices
+};
+
+// Triangulos por cluster: pequenos o bastante para cortar as meshes grandes (paredes, chao)
+const size_t MESH_CLUSTER_TRIANGLES = 256;
+// Celulas da grelha de Morton que um cluster nao atravessa: 30 - shift bits = 8x8x8 celulas
+// no modelo, uns 6 m na sala do arcade
+const int MESH_CLUSTER_CELL_SHIFT = 21;
+// Abaixo disto (cos do maior desvio ao eixo) o cone ja nao rejeita quase nada: fica desligado
+const float MESH_CONE_MIN_DOT = 0.1f;
+
 struct Mesh {
-    std::vector<float> vertices;
-    std::vector<float> normals;
-    std::vector<float> texCoords;
-    std::vector<float> colors;
+    std::vector<float> vertices;    // interleaved, OBJ_VERTEX_STRIDE floats por vertice
+    Aabb bounds = Aabb::empty();    // espaco do modelo (ja centrado)
+    std::vector<MeshCluster> clusters;
+    bool closed = false;            // fechada e com a ordem dos vertices a bater com as normais
     
     GLuint VAO = 0;
-    GLuint VBO_vertices = 0;
-    GLuint VBO_normals = 0;
-    GLuint VBO_texcoords = 0;
-    GLuint VBO_colors = 0;
+    GLuint VBO = 0;
     
     GLuint diffuseTexID = 0;
     int materialIndex = -1;
+    size_t vertexCount = 0;
+    
+    size_t cpuBytes() const {
+        return vertices.capacity() * sizeof(float) + clusters.capacity() * sizeof(MeshCluster);
+    }
+    
+    size_t gpuBytes() const {
+        return vertexCount * OBJ_VERTEX_STRIDE * sizeof(float);
+    }
+    
+    // Liberta a copia em RAM depois do upload; o VBO passa a ser a unica copia
+    void releaseCpuData() {
+        std::vector<float>().swap(vertices);
+    }
     
     void cleanup() {
-        if (VBO_vertices) { glDeleteBuffers(1, &VBO_vertices); VBO_vertices = 0; }
-        if (VBO_normals) { glDeleteBuffers(1, &VBO_normals); VBO_normals = 0; }
-        if (VBO_texcoords) { glDeleteBuffers(1, &VBO_texcoords); VBO_texcoords = 0; }
-        if (VBO_colors) { glDeleteBuffers(1, &VBO_colors); VBO_colors = 0; }
+        if (VBO) { glDeleteBuffers(1, &VBO); VBO = 0; }
         if (VAO) { glDeleteVertexArrays(1, &VAO); VAO = 0; }
         if (diffuseTexID) { glDeleteTextures(1, &diffuseTexID); diffuseTexID = 0; }
     }
@@ -60,44 +92,118 @@ private:
     float maxDimension;
     bool isLoaded;
     
-    GLuint loadTexture(const std::string& path) {
-        std::ifstream f(path.c_str());
-        if (!f.good()) return 0;
-        f.close();
-
-        GLuint textureID;
-        glGenTextures(1, &textureID);
-        
-        int width, height, channels;
-        stbi_set_flip_vertically_on_load(true);
-        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
-
-        if (data) {
-            GLenum format = GL_RGB;
-            if (channels == 1) format = GL_RED;
-            else if (channels == 3) format = GL_RGB;
-            else if (channels == 4) format = GL_RGBA;
-            
+    size_t textureVramBytes;
+    double textureUploadSeconds;
+    int cookedTextures;
+    
+    static void setTextureParameters(int levels) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        if (levels > 0) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    
+    // Textura descodificada no CPU por um job; o upload e feito depois, na thread com o contexto GL
+    struct DecodedTexture {
+        std::string path;
+        VfsFile file;
+        BtexImage cooked;                              // os mips apontam para file
+        bool isCooked = false;
+        std::vector<std::vector<uint8_t>> rgbaMips;    // cozinhada mas sem S3TC no driver
+        unsigned char* pixels = nullptr;               // stb_image
+        int width = 0, height = 0, channels = 0;
+    };
+    
+    // Textura cozinhada (<imagem>.btex): mipmaps ja feitos, comprimidos se o driver suportar S3TC,
+    // senao descomprimidos para RGBA8 aqui. Sem .btex descodifica a imagem original com stb_image
+    static void decodeTexture(DecodedTexture& tex, bool s3tc) {
+        if (Vfs::read(tex.path + BTEX_EXTENSION, tex.file) && tex.cooked.parse(tex.file.data(), tex.file.size())) {
+            tex.isCooked = true;
+            if (tex.cooked.format == BTEX_RGBA8 || !s3tc) {
+                tex.rgbaMips.resize(tex.cooked.mips.size());
+                for (size_t level = 0; level < tex.cooked.mips.size(); level++) {
+                    const BtexMip& mip = tex.cooked.mips[level];
+                    BtexImage::decodeToRgba(tex.cooked.format, mip.data, mip.width, mip.height, tex.rgbaMips[level]);
+                }
+            }
+            return;
+        }
+        if (!Vfs::read(tex.path, tex.file)) return;
+        tex.pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(tex.file.data()), (int)tex.file.size(),
+                                           &tex.width, &tex.height, &tex.channels, 0);
+    }
+    
+    GLuint uploadTexture(DecodedTexture& tex) {
+        if (tex.isCooked) {
+            GLuint textureID;
+            glGenTextures(1, &textureID);
             glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
             
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            
-            stbi_image_free(data);
+            GLenum glFormat = (tex.cooked.format == BTEX_BC1) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            for (size_t level = 0; level < tex.cooked.mips.size(); level++) {
+                const BtexMip& mip = tex.cooked.mips[level];
+                if (tex.rgbaMips.empty()) {
+                    glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, glFormat, mip.width, mip.height, 0, mip.size, mip.data);
+                    textureVramBytes += mip.size;
+                } else {
+                    glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGBA8, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.rgbaMips[level].data());
+                    textureVramBytes += tex.rgbaMips[level].size();
+                }
+            }
+            setTextureParameters((int)tex.cooked.mips.size());
+            cookedTextures++;
             return textureID;
         }
-        return 0;
+        if (!tex.pixels) return 0;
+        
+        GLenum format = GL_RGB;
+        if (tex.channels == 1) format = GL_RED;
+        else if (tex.channels == 3) format = GL_RGB;
+        else if (tex.channels == 4) format = GL_RGBA;
+        
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, tex.width, tex.height, 0, format, GL_UNSIGNED_BYTE, tex.pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        setTextureParameters(0);
+        
+        // Os drivers guardam RGB como RGBA; a cadeia de mipmaps soma mais 1/3
+        textureVramBytes += (size_t)tex.width * tex.height * 4 * 4 / 3;
+        stbi_image_free(tex.pixels);
+        tex.pixels = nullptr;
+        return textureID;
+    }
+    
+    // Descodifica todas as texturas dos materiais em paralelo (jobs()) e sobe-as por ordem
+    void loadTextures() {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < meshes.size() && i < materials.size(); i++) {
+            if (!materials[i].diffuseTexture.empty()) owners.push_back(i);
+        }
+        std::vector<DecodedTexture> decoded(owners.size());
+        for (size_t t = 0; t < owners.size(); t++) decoded[t].path = basePath + materials[owners[t]].diffuseTexture;
+        
+        // A flag do stb_image e global: fica definida antes de qualquer job
+        stbi_set_flip_vertically_on_load(true);
+        bool s3tc = GLEW_EXT_texture_compression_s3tc;
+        jobs().parallelFor(decoded.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) decodeTexture(decoded[t], s3tc);
+        });
+        for (size_t t = 0; t < owners.size(); t++) meshes[owners[t]].diffuseTexID = uploadTexture(decoded[t]);
+        textureUploadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
     
+public:
+    // Publico para o microbenchmark (bench/micro_bench.cpp); o load() ja o chama
     void calculateBounds() {
         minBounds = glm::vec3(1e10f);
         maxBounds = glm::vec3(-1e10f);
         for (const auto& mesh : meshes) {
-            for (size_t i = 0; i < mesh.vertices.size(); i += 3) {
+            for (size_t i = 0; i < mesh.vertices.size(); i += OBJ_VERTEX_STRIDE) {
                 minBounds.x = std::min(minBounds.x, mesh.vertices[i + 0]);
                 minBounds.y = std::min(minBounds.y, mesh.vertices[i + 1]);
                 minBounds.z = std::min(minBounds.z, mesh.vertices[i + 2]);
@@ -111,9 +217,10 @@ private:
         maxDimension = std::max(size.x, std::max(size.y, size.z));
     }
     
+private:
     void centerModel() {
         for (auto& mesh : meshes) {
-            for (size_t i = 0; i < mesh.vertices.size(); i += 3) {
+            for (size_t i = 0; i < mesh.vertices.size(); i += OBJ_VERTEX_STRIDE) {
                 mesh.vertices[i + 0] -= center.x;
                 mesh.vertices[i + 1] -= center.y;
                 mesh.vertices[i + 2] -= center.z;
@@ -122,9 +229,162 @@ private:
         maxBounds -= center; minBounds -= center; center = glm::vec3(0.0f);
     }
     
+    // 10 bits por eixo intercalados: x nos bits 0, 3, 6...
+    static uint32_t expandBits(uint32_t v) {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+    
+    // Eixo dominante da normal com sinal (0..5): a caixa de um movel tem as seis faces juntas no
+    // espaco e so separando-as por lado e que os cones dos clusters ficam estreitos
+    static uint32_t facingBucket(const glm::vec3& normal) {
+        glm::vec3 m = glm::abs(normal);
+        int axis = (m.x >= m.y && m.x >= m.z) ? 0 : (m.y >= m.z ? 1 : 2);
+        return (uint32_t)(axis * 2 + (normal[axis] < 0.0f ? 1 : 0));
+    }
+    
+    static glm::vec3 vertexPosition(const std::vector<float>& vertices, size_t v) {
+        const float* p = &vertices[v * OBJ_VERTEX_STRIDE];
+        return glm::vec3(p[0], p[1], p[2]);
+    }
+    
+    // Reordena os triangulos de cada mesh pelo lado para onde estao virados e depois pela curva
+    // de Morton do centroide (nos bounds do modelo), e corta-os em clusters de
+    // MESH_CLUSTER_TRIANGLES: cada cluster fica compacto no espaco e com um cone de normais
+    // estreito. Corre no load, com os vertices ja centrados e ainda em RAM
+    void buildClusters() {
+        glm::vec3 extent = glm::max(maxBounds - minBounds, glm::vec3(1e-6f));
+        std::vector<std::pair<uint64_t, uint32_t>> order;
+        std::vector<float> sorted;
+        const size_t triangleFloats = 3 * OBJ_VERTEX_STRIDE;
+        
+        for (auto& mesh : meshes) {
+            mesh.bounds = Aabb::empty();
+            mesh.clusters.clear();
+            size_t triangles = mesh.vertexCount / 3;
+            
+            order.resize(triangles);
+            for (size_t t = 0; t < triangles; t++) {
+                glm::vec3 a = vertexPosition(mesh.vertices, t * 3), b = vertexPosition(mesh.vertices, t * 3 + 1), c = vertexPosition(mesh.vertices, t * 3 + 2);
+                glm::vec3 cell = glm::clamp(((a + b + c) * (1.0f / 3.0f) - minBounds) / extent, glm::vec3(0.0f), glm::vec3(1.0f)) * 1023.0f;
+                uint32_t code = expandBits((uint32_t)cell.x) | (expandBits((uint32_t)cell.y) << 1) | (expandBits((uint32_t)cell.z) << 2);
+                order[t] = std::make_pair(((uint64_t)facingBucket(glm::cross(b - a, c - a)) << 32) | code, (uint32_t)t);
+            }
+            std::sort(order.begin(), order.end());
+            sorted.resize(mesh.vertices.size());
+            for (size_t t = 0; t < triangles; t++) {
+                const float* src = &mesh.vertices[order[t].second * triangleFloats];
+                std::copy(src, src + triangleFloats, &sorted[t * triangleFloats]);
+            }
+            // Restos (vertices fora de um triangulo completo) ficam no fim como estavam
+            std::copy(mesh.vertices.begin() + triangles * triangleFloats, mesh.vertices.end(), sorted.begin() + triangles * triangleFloats);
+            mesh.vertices.swap(sorted);
+            
+            for (size_t firstTriangle = 0, endTriangle = 0; firstTriangle < triangles; firstTriangle = endTriangle) {
+                // Um cluster nunca junta dois lados nem duas celulas da grelha: acaba no limite de
+                // tamanho ou quando o lado ou a celula (os bits altos do codigo de Morton) mudam
+                uint64_t cell = order[firstTriangle].first >> MESH_CLUSTER_CELL_SHIFT;
+                endTriangle = firstTriangle + 1;
+                while (endTriangle < triangles && endTriangle - firstTriangle < MESH_CLUSTER_TRIANGLES && (order[endTriangle].first >> MESH_CLUSTER_CELL_SHIFT) == cell) endTriangle++;
+                MeshCluster cluster{ Aabb::empty(), NormalCone::disabled(), (GLint)(firstTriangle * 3), (GLsizei)((endTriangle - firstTriangle) * 3) };
+                
+                // Eixo = media das normais das faces (pela ordem dos vertices, como o glCullFace)
+                glm::vec3 normalSum(0.0f);
+                for (size_t t = firstTriangle; t < endTriangle; t++) {
+                    glm::vec3 a = vertexPosition(mesh.vertices, t * 3), b = vertexPosition(mesh.vertices, t * 3 + 1), c = vertexPosition(mesh.vertices, t * 3 + 2);
+                    cluster.bounds.expand(a); cluster.bounds.expand(b); cluster.bounds.expand(c);
+                    glm::vec3 n = glm::cross(b - a, c - a);
+                    float length = glm::length(n);
+                    if (length > 1e-12f) normalSum += n / length;
+                }
+                float sumLength = glm::length(normalSum);
+                if (sumLength > 1e-6f) {
+                    glm::vec3 axis = normalSum / sumLength;
+                    float minDot = 1.0f;
+                    for (size_t t = firstTriangle; t < endTriangle; t++) {
+                        glm::vec3 a = vertexPosition(mesh.vertices, t * 3);
+                        glm::vec3 n = glm::cross(vertexPosition(mesh.vertices, t * 3 + 1) - a, vertexPosition(mesh.vertices, t * 3 + 2) - a);
+                        float length = glm::length(n);
+                        if (length > 1e-12f) minDot = std::min(minDot, glm::dot(n, axis) / length);
+                    }
+                    if (minDot >= MESH_CONE_MIN_DOT) cluster.cone = NormalCone{ axis, std::sqrt(1.0f - minDot * minDot) };
+                }
+                mesh.bounds.expand(cluster.bounds);
+                mesh.clusters.push_back(cluster);
+            }
+        }
+    }
+    
+    // Uma mesh so pode ter as faces de tras cortadas se for um solido fechado (cada aresta
+    // orientada a->b tem a inversa b->a, com as posicoes iguais bit a bit) e se todos os
+    // triangulos estiverem virados para o lado das normais guardadas. Sem normais nao se
+    // sabe o lado, e a mesh fica de fora
+    void checkClosed() {
+        std::vector<std::pair<std::pair<float, float>, std::pair<float, uint32_t>>> points;
+        std::vector<uint32_t> ids;
+        std::vector<uint64_t> edges;
+        
+        for (auto& mesh : meshes) {
+            mesh.closed = false;
+            size_t triangles = mesh.vertexCount / 3;
+            if (triangles == 0 || mesh.vertexCount % 3 != 0) continue;
+            
+            bool wound = true;
+            for (size_t t = 0; t < triangles && wound; t++) {
+                const float* v = &mesh.vertices[t * 3 * OBJ_VERTEX_STRIDE];
+                glm::vec3 a = vertexPosition(mesh.vertices, t * 3), b = vertexPosition(mesh.vertices, t * 3 + 1), c = vertexPosition(mesh.vertices, t * 3 + 2);
+                glm::vec3 normal(0.0f);
+                for (int k = 0; k < 3; k++) normal += glm::vec3(v[k * OBJ_VERTEX_STRIDE + 3], v[k * OBJ_VERTEX_STRIDE + 4], v[k * OBJ_VERTEX_STRIDE + 5]);
+                glm::vec3 face = glm::cross(b - a, c - a);
+                if (glm::length(face) <= 1e-12f) continue;
+                wound = glm::dot(face, normal) > 0.0f;
+            }
+            if (!wound) continue;
+            
+            // Ids das posicoes: iguais bit a bit => mesmo id
+            points.resize(mesh.vertexCount);
+            for (size_t i = 0; i < mesh.vertexCount; i++) {
+                glm::vec3 p = vertexPosition(mesh.vertices, i);
+                points[i] = std::make_pair(std::make_pair(p.x, p.y), std::make_pair(p.z, (uint32_t)i));
+            }
+            std::sort(points.begin(), points.end());
+            ids.resize(mesh.vertexCount);
+            uint32_t id = 0;
+            for (size_t i = 0; i < points.size(); i++) {
+                if (i > 0 && (points[i].first != points[i - 1].first || points[i].second.first != points[i - 1].second.first)) id++;
+                ids[points[i].second.second] = id;
+            }
+            
+            edges.clear();
+            for (size_t t = 0; t < triangles; t++) {
+                uint32_t a = ids[t * 3], b = ids[t * 3 + 1], c = ids[t * 3 + 2];
+                if (a == b || b == c || c == a) continue;
+                edges.push_back(((uint64_t)a << 32) | b);
+                edges.push_back(((uint64_t)b << 32) | c);
+                edges.push_back(((uint64_t)c << 32) | a);
+            }
+            std::sort(edges.begin(), edges.end());
+            // Fechada se cada aresta aparece tantas vezes como a sua inversa
+            bool closed = !edges.empty();
+            for (size_t i = 0; i < edges.size() && closed; ) {
+                size_t j = i;
+                while (j < edges.size() && edges[j] == edges[i]) j++;
+                uint64_t reverse = (edges[i] << 32) | (edges[i] >> 32);
+                auto range = std::equal_range(edges.begin(), edges.end(), reverse);
+                closed = (size_t)(range.second - range.first) == j - i;
+                i = j;
+            }
+            mesh.closed = closed;
+        }
+    }
+    
 public:
     Model3D(const std::string& objPath, const std::string& baseDir = "") 
-        : modelPath(objPath), basePath(baseDir), center(0.0f), maxDimension(1.0f), isLoaded(false) {
+        : modelPath(objPath), basePath(baseDir), center(0.0f), maxDimension(1.0f), isLoaded(false),
+          textureVramBytes(0), textureUploadSeconds(0.0), cookedTextures(0) {
         if (basePath.empty()) {
             size_t pos = objPath.find_last_of("/\\");
             if (pos != std::string::npos) basePath = objPath.substr(0, pos + 1);
@@ -135,14 +395,13 @@ public:
     
     bool load() {
         std::cout << "Loading Model: " << modelPath << std::endl;
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> objMaterials;
-        std::string warn, err;
+        ObjData data;
+        std::string err;
         
-        bool success = tinyobj::LoadObj(&attrib, &shapes, &objMaterials, &warn, &err, modelPath.c_str(), basePath.c_str());
-        if (!success) { return false; }
+        bool success = ObjParser::loadParallel(modelPath, basePath, data, err);
+        if (!success) { std::cerr << "OBJ parse error: " << err << std::endl; return false; }
         
+        const std::vector<tinyobj::material_t>& objMaterials = data.materials;
         materials.resize(std::max((size_t)1, objMaterials.size()));
         for (size_t i = 0; i < objMaterials.size(); i++) {
             materials[i].ambient = glm::vec3(objMaterials[i].ambient[0], objMaterials[i].ambient[1], objMaterials[i].ambient[2]);
@@ -152,97 +411,97 @@ public:
             materials[i].diffuseTexture = objMaterials[i].diffuse_texname;
         }
         
-        if (objMaterials.empty()) meshes.resize(1);
-        else meshes.resize(objMaterials.size());
-        
-        for (size_t s = 0; s < shapes.size(); s++) {
-            size_t index_offset = 0;
-            for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++) {
-                size_t fv = shapes[s].mesh.num_face_vertices[f];
-                int material_id = shapes[s].mesh.material_ids[f];
-                int meshIndex = (material_id < 0) ? 0 : material_id;
-                if (meshIndex >= (int)meshes.size()) meshIndex = 0;
-                
-                for (size_t v = 0; v < fv; v++) {
-                    tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
-                    if (idx.vertex_index >= 0) {
-                        meshes[meshIndex].vertices.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
-                        meshes[meshIndex].vertices.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
-                        meshes[meshIndex].vertices.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
-                    }
-                    if (idx.normal_index >= 0) {
-                        meshes[meshIndex].normals.push_back(attrib.normals[3 * idx.normal_index + 0]);
-                        meshes[meshIndex].normals.push_back(attrib.normals[3 * idx.normal_index + 1]);
-                        meshes[meshIndex].normals.push_back(attrib.normals[3 * idx.normal_index + 2]);
-                    } else {
-                        meshes[meshIndex].normals.push_back(0.0f); meshes[meshIndex].normals.push_back(1.0f); meshes[meshIndex].normals.push_back(0.0f);
-                    }
-                    if (idx.texcoord_index >= 0) {
-                        meshes[meshIndex].texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
-                        meshes[meshIndex].texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
-                    } else {
-                        meshes[meshIndex].texCoords.push_back(0.0f); meshes[meshIndex].texCoords.push_back(0.0f);
-                    }
-                    meshes[meshIndex].colors.push_back(1.0f); meshes[meshIndex].colors.push_back(1.0f); meshes[meshIndex].colors.push_back(1.0f);
-                }
-                index_offset += fv;
-            }
-        }
+        meshes.resize(data.meshes.size());
+        for (size_t i = 0; i < data.meshes.size(); i++) meshes[i].vertices.swap(data.meshes[i].vertices);
         
         int validMeshes = 0;
-        for (const auto& mesh : meshes) if (!mesh.vertices.empty()) validMeshes++;
+        for (auto& mesh : meshes) {
+            mesh.vertexCount = mesh.vertices.size() / OBJ_VERTEX_STRIDE;
+            if (mesh.vertexCount > 0) validMeshes++;
+        }
         if (validMeshes == 0) return false;
         
         calculateBounds();
         centerModel();
+        buildClusters();
+        checkClosed();
         isLoaded = true;
         return true;
     }
     
-    void setupMeshes() {
+    // Luz difusa de um ponto de luz (no mundo, com a transformacao do modelo) gravada na cor de
+    // cada vertice: o mesmo ambiente + difuso de fragment.frag, ja multiplicado pela cor do
+    // material nas meshes sem textura. Tem de correr entre o load() e o setupMeshes()
+    void bakeLighting(const glm::mat4& model, const glm::vec3& lightPos, const glm::vec3& lightColor) {
+        if (!isLoaded) return;
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+        for (size_t m = 0; m < meshes.size(); m++) {
+            Mesh& mesh = meshes[m];
+            if (mesh.vertices.empty()) continue;
+
+            // Mesmas cores que render(), incluindo o cinzento das meshes sem material
+            glm::vec3 diffuseColor(0.0f), ambientColor(0.0f);
+            if (m < materials.size()) { diffuseColor = materials[m].diffuse; ambientColor = materials[m].ambient; }
+            if (glm::length(diffuseColor) < 0.001f) { diffuseColor = glm::vec3(0.15f); ambientColor = glm::vec3(0.075f); }
+            glm::vec3 ambientBase = (glm::length(ambientColor) > 0.0f) ? ambientColor : glm::vec3(0.2f, 0.1f, 0.4f);
+            // Com textura a cor vem dela no shader; aqui fica so a luz
+            bool textured = m < materials.size() && !materials[m].diffuseTexture.empty();
+            glm::vec3 tint = textured ? glm::vec3(1.0f) : diffuseColor;
+
+            for (size_t v = 0; v < mesh.vertexCount; v++) {
+                float* p = &mesh.vertices[v * OBJ_VERTEX_STRIDE];
+                glm::vec3 normal(p[3], p[4], p[5]);
+                // OBJ sem normais: a da face do triangulo
+                if (glm::length(normal) < 1e-6f && v / 3 * 3 + 2 < mesh.vertexCount) {
+                    size_t first = v / 3 * 3;
+                    glm::vec3 a = vertexPosition(mesh.vertices, first), b = vertexPosition(mesh.vertices, first + 1), c = vertexPosition(mesh.vertices, first + 2);
+                    normal = glm::cross(b - a, c - a);
+                }
+                glm::vec3 world = glm::vec3(model * glm::vec4(p[0], p[1], p[2], 1.0f));
+                float diff = 0.0f;
+                if (glm::length(normal) >= 1e-6f) diff = std::max(glm::dot(glm::normalize(normalMatrix * normal), glm::normalize(lightPos - world)), 0.0f);
+                glm::vec3 color = (ambientBase + diff) * lightColor * tint;
+                p[8] = color.x; p[9] = color.y; p[10] = color.z;
+            }
+        }
+    }
+
+    void setupMeshes(bool releaseCpuData = false) {
         if (!isLoaded) return;
         for (size_t i = 0; i < meshes.size(); i++) {
             auto& mesh = meshes[i];
-            if (mesh.vertices.empty()) continue;
+            if (mesh.vertexCount == 0) continue;
             
+            const GLsizei stride = OBJ_VERTEX_STRIDE * sizeof(float);
             glGenVertexArrays(1, &mesh.VAO); glBindVertexArray(mesh.VAO);
-            glGenBuffers(1, &mesh.VBO_vertices); glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO_vertices);
+            glGenBuffers(1, &mesh.VBO); glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
             glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); glEnableVertexAttribArray(0);
-            
-            if (!mesh.normals.empty()) {
-                glGenBuffers(1, &mesh.VBO_normals); glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO_normals);
-                glBufferData(GL_ARRAY_BUFFER, mesh.normals.size() * sizeof(float), mesh.normals.data(), GL_STATIC_DRAW);
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); glEnableVertexAttribArray(1);
-            }
-            if (!mesh.texCoords.empty()) {
-                glGenBuffers(1, &mesh.VBO_texcoords); glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO_texcoords);
-                glBufferData(GL_ARRAY_BUFFER, mesh.texCoords.size() * sizeof(float), mesh.texCoords.data(), GL_STATIC_DRAW);
-                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)0); glEnableVertexAttribArray(2);
-            }
-            if (!mesh.colors.empty()) {
-                glGenBuffers(1, &mesh.VBO_colors); glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO_colors);
-                glBufferData(GL_ARRAY_BUFFER, mesh.colors.size() * sizeof(float), mesh.colors.data(), GL_STATIC_DRAW);
-                glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); glEnableVertexAttribArray(3);
-            }
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0); glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(8 * sizeof(float))); glEnableVertexAttribArray(3);
             glBindVertexArray(0);
+            if (releaseCpuData) mesh.releaseCpuData();
         }
-        for (size_t i = 0; i < meshes.size(); i++) {
-            if (i < materials.size()) {
-                meshes[i].materialIndex = i;
-                if (!materials[i].diffuseTexture.empty()) {
-                    std::string texPath = basePath + materials[i].diffuseTexture;
-                    meshes[i].diffuseTexID = loadTexture(texPath);
-                }
-            }
-        }
+        for (size_t i = 0; i < meshes.size() && i < materials.size(); i++) meshes[i].materialIndex = i;
+        loadTextures();
     }
     
-    void render(GLuint shaderProgram) {
+    // Com frustum (no espaco do modelo: projection * view * model) salta as meshes fora da
+    // vista e, nas que ficam, desenha so os clusters visiveis (os contiguos num so draw).
+    // Com eye (camara no espaco do modelo, fora dos solidos) liga o GL_CULL_FACE nas meshes
+    // fechadas (checkClosed) e tira-lhes tambem os clusters todos de costas; as outras
+    // desenham-se das duas faces. Sai sempre com o GL_CULL_FACE desligado
+    void render(GLuint shaderProgram, const Frustum* frustum = nullptr, const glm::vec3* eye = nullptr) {
         if (!isLoaded) return;
         
+        bool culling = false;
         for (const auto& mesh : meshes) {
-            if (mesh.vertices.empty() || mesh.VAO == 0) continue;
+            if (mesh.vertexCount == 0 || mesh.VAO == 0) continue;
+            if (frustum && !frustum->intersects(mesh.bounds)) {
+                profiler().countCulling(false, 0, (unsigned)mesh.clusters.size());
+                continue;
+            }
             
             bool hasTexture = (mesh.diffuseTexID != 0);
             if (hasTexture) {
@@ -279,10 +538,34 @@ public:
                 glUniform1f(glGetUniformLocation(shaderProgram, "material.shininess"), shininess);
             }
             
+            bool cull = eye && mesh.closed;
+            if (cull != culling) {
+                if (cull) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+                culling = cull;
+            }
+            
             glBindVertexArray(mesh.VAO);
-            glDrawArrays(GL_TRIANGLES, 0, mesh.vertices.size() / 3);
+            if (!frustum) {
+                glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mesh.vertexCount);
+                profiler().countDraw((unsigned)mesh.vertexCount);
+            } else {
+                unsigned culled = 0, backfacing = 0;
+                GLint runFirst = 0;
+                GLsizei runCount = 0;
+                for (const MeshCluster& cluster : mesh.clusters) {
+                    if (!frustum->intersects(cluster.bounds)) { culled++; continue; }
+                    if (cull && cluster.cone.backfacing(*eye, cluster.bounds)) { backfacing++; continue; }
+                    if (runCount && runFirst + runCount == cluster.first) { runCount += cluster.count; continue; }
+                    if (runCount) { glDrawArrays(GL_TRIANGLES, runFirst, runCount); profiler().countDraw((unsigned)runCount); }
+                    runFirst = cluster.first;
+                    runCount = cluster.count;
+                }
+                if (runCount) { glDrawArrays(GL_TRIANGLES, runFirst, runCount); profiler().countDraw((unsigned)runCount); }
+                profiler().countCulling(true, (unsigned)mesh.clusters.size() - culled - backfacing, culled, backfacing);
+            }
             glBindVertexArray(0);
         }
+        if (culling) glDisable(GL_CULL_FACE);
     }
     
     void cleanup() {
@@ -294,6 +577,22 @@ public:
     glm::vec3 getMinBounds() const { return minBounds; }
     glm::vec3 getMaxBounds() const { return maxBounds; }
     float getMaxDimension() const { return maxDimension; }
+    
+    size_t cpuMemoryBytes() const {
+        size_t total = meshes.capacity() * sizeof(Mesh) + materials.capacity() * sizeof(Material);
+        for (const auto& mesh : meshes) total += mesh.cpuBytes();
+        return total;
+    }
+    
+    size_t gpuMemoryBytes() const {
+        size_t total = 0;
+        for (const auto& mesh : meshes) if (mesh.VAO) total += mesh.gpuBytes();
+        return total;
+    }
+    
+    size_t textureMemoryBytes() const { return textureVramBytes; }
+    double textureUploadTime() const { return textureUploadSeconds; }
+    int cookedTextureCount() const { return cookedTextures; }
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include <fstream>
 
-#define TINYOBJLOADER_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
 #include "Model3D.hpp"
 
@@ -0,0 +1,513 @@
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "ObjParser.hpp"
+#include "vfs.h"
+
+#include <fstream>
+#include <map>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* lineEnd(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    return nl ? nl : end;
+}
+
+inline bool isKeyword(const char* p, const char* end, const char* kw, size_t len) {
+    if ((size_t)(end - p) < len || memcmp(p, kw, len) != 0) return false;
+    return p + len == end || p[len] == ' ' || p[len] == '\t';
+}
+
+float parseFloat(const char*& p, const char* end) {
+    p = skipSpaces(p, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+
+    double value = 0.0;
+    while (p < end && isDigit(*p)) { value = value * 10.0 + (*p - '0'); ++p; }
+    if (p < end && *p == '.') {
+        ++p;
+        double scale = 0.1;
+        while (p < end && isDigit(*p)) { value += (*p - '0') * scale; scale *= 0.1; ++p; }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool expNeg = false;
+        if (p < end && (*p == '-' || *p == '+')) { expNeg = (*p == '-'); ++p; }
+        int exponent = 0;
+        while (p < end && isDigit(*p)) { exponent = exponent * 10 + (*p - '0'); ++p; }
+        value *= std::pow(10.0, expNeg ? -exponent : exponent);
+    }
+    return (float)(neg ? -value : value);
+}
+
+int parseInt(const char*& p, const char* end) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+    int value = 0;
+    while (p < end && isDigit(*p)) { value = value * 10 + (*p - '0'); ++p; }
+    return neg ? -value : value;
+}
+
+std::string parseName(const char* p, const char* end) {
+    p = skipSpaces(p, end);
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+    return std::string(p, end);
+}
+
+// Indices OBJ: 1-based, ou negativos relativos ao numero de elementos ja lidos
+inline int resolveIndex(int idx, size_t count) {
+    if (idx > 0) return idx - 1;
+    if (idx < 0) return (int)count + idx;
+    return -1;
+}
+
+struct Corner { int v, vt, vn; };
+
+bool parseCorner(const char*& p, const char* end, Corner& c) {
+    p = skipSpaces(p, end);
+    if (p >= end || *p == '\r') return false;
+    c.v = parseInt(p, end); c.vt = 0; c.vn = 0;
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/') c.vt = parseInt(p, end);
+        if (p < end && *p == '/') { ++p; c.vn = parseInt(p, end); }
+    }
+    while (p < end && *p != ' ' && *p != '\t') ++p;
+    return true;
+}
+
+float distance2(const std::vector<float>& positions, int a, int b) {
+    float dx = positions[3 * a + 0] - positions[3 * b + 0];
+    float dy = positions[3 * a + 1] - positions[3 * b + 1];
+    float dz = positions[3 * a + 2] - positions[3 * b + 2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+bool diagonal13IsShorter(const std::vector<float>& positions, const std::vector<Corner>& quad) {
+    return distance2(positions, quad[1].v, quad[3].v) < distance2(positions, quad[0].v, quad[2].v);
+}
+
+size_t countCorners(const char* p, const char* end) {
+    size_t n = 0;
+    while (true) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '\r') return n;
+        n++;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+    }
+}
+
+// istream sobre memoria ja carregada, para passar ao tinyobj::LoadMtl sem copias
+struct MemoryBuffer : std::streambuf {
+    MemoryBuffer(const char* data, size_t size) {
+        char* p = const_cast<char*>(data);
+        setg(p, p, p + size);
+    }
+};
+
+void loadMaterialLibrary(const std::string& path, std::vector<tinyobj::material_t>& materials,
+                         std::map<std::string, int>& materialMap, std::string& warn) {
+    VfsFile mtlFile;
+    if (!Vfs::read(path, mtlFile)) { warn += "Material file not found: " + path + "\n"; return; }
+    MemoryBuffer buffer(mtlFile.data(), mtlFile.size());
+    std::istream mtlStream(&buffer);
+    std::string mtlErr;
+    tinyobj::LoadMtl(&materialMap, &materials, &mtlStream, &warn, &mtlErr);
+}
+
+int lookupMaterial(const std::map<std::string, int>& materialMap, const std::string& name) {
+    auto it = materialMap.find(name);
+    return it == materialMap.end() ? -1 : it->second;
+}
+
+inline size_t bucketFor(int materialId, size_t bucketCount) {
+    return (materialId < 0 || (size_t)materialId >= bucketCount) ? 0 : (size_t)materialId;
+}
+
+// Triangula um poligono (quads pela diagonal mais curta, como o tinyobj; restantes em leque)
+// e escreve os vertices interleaved em w, avancando o cursor
+void writePolygon(std::vector<Corner>& corners, const std::vector<float>& positions, const std::vector<float>& normals,
+                  const std::vector<float>& texcoords, float*& w) {
+    if (corners.size() == 4 && diagonal13IsShorter(positions, corners)) {
+        std::rotate(corners.begin(), corners.begin() + 1, corners.end());
+    }
+    for (size_t t = 1; t + 1 < corners.size(); t++) {
+        const Corner* tri[3] = { &corners[0], &corners[t], &corners[t + 1] };
+        for (const Corner* k : tri) {
+            const float* pos = &positions[3 * k->v];
+            w[0] = pos[0]; w[1] = pos[1]; w[2] = pos[2];
+            if (k->vn >= 0) { const float* n = &normals[3 * k->vn]; w[3] = n[0]; w[4] = n[1]; w[5] = n[2]; }
+            else { w[3] = 0.0f; w[4] = 1.0f; w[5] = 0.0f; }
+            if (k->vt >= 0) { const float* uv = &texcoords[2 * k->vt]; w[6] = uv[0]; w[7] = uv[1]; }
+            else { w[6] = 0.0f; w[7] = 0.0f; }
+            w[8] = 1.0f; w[9] = 1.0f; w[10] = 1.0f;
+            w += OBJ_VERTEX_STRIDE;
+        }
+    }
+}
+
+// Bits de RawCorner::relative: indice negativo no ficheiro, relativo ao inicio do chunk
+const unsigned char REL_V = 1, REL_VT = 2, REL_VN = 4;
+
+struct RawCorner {
+    int v, vt, vn;
+    unsigned char relative;
+};
+
+// Fatia do ficheiro alinhada a linhas, tokenizada de forma independente
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::string err;
+
+    std::vector<float> positions, normals, texcoords;
+    std::vector<RawCorner> corners;
+    std::vector<unsigned> faceSizes;
+    std::vector<std::string> mtllibs;
+
+    // Run 0 herda o material do chunk anterior; cada usemtl abre um novo run
+    std::vector<size_t> runFirstFace;
+    std::vector<std::string> runNames;
+    std::vector<size_t> runVertices;
+    std::vector<int> runMaterials;
+
+    size_t vOffset = 0, vtOffset = 0, vnOffset = 0;
+    std::vector<size_t> bucketStart;
+};
+
+inline int localIndex(int idx, size_t localCount, unsigned char bit, unsigned char& relative) {
+    if (idx > 0) return idx - 1;
+    if (idx < 0) { relative |= bit; return (int)localCount + idx; }
+    return -1;
+}
+
+void tokenizeChunk(ObjChunk& chunk) {
+    const char* end = chunk.end;
+    chunk.runFirstFace.push_back(0);
+    chunk.runNames.push_back(std::string());
+    chunk.runVertices.push_back(0);
+
+    for (const char* line = chunk.begin; line < end; ) {
+        const char* eol = lineEnd(line, end);
+        const char* p = skipSpaces(line, eol);
+        if (p < eol) {
+            if (isKeyword(p, eol, "v", 1)) {
+                p += 1;
+                chunk.positions.push_back(parseFloat(p, eol));
+                chunk.positions.push_back(parseFloat(p, eol));
+                chunk.positions.push_back(parseFloat(p, eol));
+            } else if (isKeyword(p, eol, "vn", 2)) {
+                p += 2;
+                chunk.normals.push_back(parseFloat(p, eol));
+                chunk.normals.push_back(parseFloat(p, eol));
+                chunk.normals.push_back(parseFloat(p, eol));
+            } else if (isKeyword(p, eol, "vt", 2)) {
+                p += 2;
+                chunk.texcoords.push_back(parseFloat(p, eol));
+                chunk.texcoords.push_back(parseFloat(p, eol));
+            } else if (isKeyword(p, eol, "f", 1)) {
+                p += 1;
+                unsigned count = 0;
+                Corner c;
+                while (parseCorner(p, eol, c)) {
+                    RawCorner raw;
+                    raw.relative = 0;
+                    raw.v = localIndex(c.v, chunk.positions.size() / 3, REL_V, raw.relative);
+                    raw.vt = localIndex(c.vt, chunk.texcoords.size() / 2, REL_VT, raw.relative);
+                    raw.vn = localIndex(c.vn, chunk.normals.size() / 3, REL_VN, raw.relative);
+                    chunk.corners.push_back(raw);
+                    count++;
+                }
+                chunk.faceSizes.push_back(count);
+                if (count >= 3) chunk.runVertices.back() += 3 * (count - 2);
+            } else if (isKeyword(p, eol, "usemtl", 6)) {
+                chunk.runFirstFace.push_back(chunk.faceSizes.size());
+                chunk.runNames.push_back(parseName(p + 6, eol));
+                chunk.runVertices.push_back(0);
+            } else if (isKeyword(p, eol, "mtllib", 6)) {
+                chunk.mtllibs.push_back(parseName(p + 6, eol));
+            }
+        }
+        line = eol + 1;
+    }
+}
+
+void expandChunk(ObjChunk& chunk, ObjData& out, const std::vector<float>& positions, const std::vector<float>& normals,
+                 const std::vector<float>& texcoords) {
+    size_t bucketCount = out.meshes.size();
+    std::vector<float*> cursors(bucketCount);
+    for (size_t b = 0; b < bucketCount; b++) cursors[b] = out.meshes[b].vertices.data() + chunk.bucketStart[b] * OBJ_VERTEX_STRIDE;
+
+    size_t numV = positions.size() / 3, numVt = texcoords.size() / 2, numVn = normals.size() / 3;
+    std::vector<Corner> corners;
+    corners.reserve(16);
+    size_t cornerIndex = 0, run = 0;
+
+    for (size_t f = 0; f < chunk.faceSizes.size(); f++) {
+        while (run + 1 < chunk.runFirstFace.size() && chunk.runFirstFace[run + 1] <= f) run++;
+        corners.clear();
+        for (unsigned k = 0; k < chunk.faceSizes[f]; k++) {
+            const RawCorner& raw = chunk.corners[cornerIndex++];
+            Corner c;
+            c.v = raw.v + ((raw.relative & REL_V) ? (int)chunk.vOffset : 0);
+            c.vt = raw.vt + ((raw.relative & REL_VT) ? (int)chunk.vtOffset : 0);
+            c.vn = raw.vn + ((raw.relative & REL_VN) ? (int)chunk.vnOffset : 0);
+            if (c.v < 0 || (size_t)c.v >= numV) { chunk.err = "Invalid vertex index in face"; return; }
+            if (c.vt < 0 || (size_t)c.vt >= numVt) c.vt = -1;
+            if (c.vn < 0 || (size_t)c.vn >= numVn) c.vn = -1;
+            corners.push_back(c);
+        }
+        if (corners.size() >= 3) writePolygon(corners, positions, normals, texcoords, cursors[bucketFor(chunk.runMaterials[run], bucketCount)]);
+    }
+}
+
+// Um chunk por job; os jobs sao roubados pelos workers livres
+template <typename Fn>
+void forEachChunk(JobSystem& pool, size_t count, Fn fn) {
+    pool.parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) fn(i);
+    });
+}
+
+} // namespace
+
+bool ObjParser::loadTinyObj(const std::string& path, const std::string& basePath, ObjData& out, std::string& err) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::string warn;
+
+    out = ObjData();
+    if (!tinyobj::LoadObj(&attrib, &shapes, &out.materials, &warn, &err, path.c_str(), basePath.c_str())) return false;
+
+    std::ifstream sizeProbe(path.c_str(), std::ios::binary | std::ios::ate);
+    out.sourceBytes = (size_t)std::max<std::streamoff>(0, sizeProbe.tellg());
+
+    out.meshes.resize(std::max((size_t)1, out.materials.size()));
+    for (size_t s = 0; s < shapes.size(); s++) {
+        size_t index_offset = 0;
+        for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++) {
+            size_t fv = shapes[s].mesh.num_face_vertices[f];
+            std::vector<float>& dst = out.meshes[bucketFor(shapes[s].mesh.material_ids[f], out.meshes.size())].vertices;
+
+            for (size_t v = 0; v < fv; v++) {
+                tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
+                if (idx.vertex_index < 0) continue;
+                dst.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
+                dst.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
+                dst.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
+                if (idx.normal_index >= 0) {
+                    dst.push_back(attrib.normals[3 * idx.normal_index + 0]);
+                    dst.push_back(attrib.normals[3 * idx.normal_index + 1]);
+                    dst.push_back(attrib.normals[3 * idx.normal_index + 2]);
+                } else {
+                    dst.push_back(0.0f); dst.push_back(1.0f); dst.push_back(0.0f);
+                }
+                if (idx.texcoord_index >= 0) {
+                    dst.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
+                    dst.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
+                } else {
+                    dst.push_back(0.0f); dst.push_back(0.0f);
+                }
+                dst.push_back(1.0f); dst.push_back(1.0f); dst.push_back(1.0f);
+            }
+            index_offset += fv;
+        }
+    }
+    for (auto& mesh : out.meshes) mesh.vertexCount = mesh.vertices.size() / OBJ_VERTEX_STRIDE;
+    return true;
+}
+
+bool ObjParser::loadStreaming(const std::string& path, const std::string& basePath, ObjData& out, std::string& err) {
+    VfsFile file;
+    if (!Vfs::read(path, file)) { err = "Cannot open " + path; return false; }
+    return parseStreaming(file.data(), file.size(), basePath, out, err);
+}
+
+bool ObjParser::parseStreaming(const char* data, size_t size, const std::string& basePath, ObjData& out, std::string& err) {
+    out = ObjData();
+    out.sourceBytes = size;
+    const char* end = data + size;
+
+    std::map<std::string, int> materialMap;
+    std::string warn;
+
+    // Passagem 1: contar atributos e vertices finais (apos triangulacao) por material
+    size_t numV = 0, numVn = 0, numVt = 0;
+    std::vector<size_t> bucketVertices(1, 0);
+    std::vector<int> usemtlIds;
+    int currentMaterial = -1;
+
+    for (const char* line = data; line < end; ) {
+        const char* eol = lineEnd(line, end);
+        const char* p = skipSpaces(line, eol);
+        if (p < eol) {
+            if (p[0] == 'v') {
+                if (isKeyword(p, eol, "v", 1)) numV++;
+                else if (isKeyword(p, eol, "vn", 2)) numVn++;
+                else if (isKeyword(p, eol, "vt", 2)) numVt++;
+            } else if (isKeyword(p, eol, "f", 1)) {
+                size_t corners = countCorners(p + 1, eol);
+                if (corners >= 3) {
+                    size_t bucket = currentMaterial < 0 ? 0 : (size_t)currentMaterial;
+                    if (bucket >= bucketVertices.size()) bucketVertices.resize(bucket + 1, 0);
+                    bucketVertices[bucket] += 3 * (corners - 2);
+                }
+            } else if (isKeyword(p, eol, "usemtl", 6)) {
+                currentMaterial = lookupMaterial(materialMap, parseName(p + 6, eol));
+                usemtlIds.push_back(currentMaterial);
+            } else if (isKeyword(p, eol, "mtllib", 6)) {
+                loadMaterialLibrary(basePath + parseName(p + 6, eol), out.materials, materialMap, warn);
+            }
+        }
+        line = eol + 1;
+    }
+
+    // Materiais desconhecidos ou fora de alcance caem no bucket 0, como no caminho tinyobj
+    size_t bucketCount = std::max((size_t)1, out.materials.size());
+    for (size_t b = bucketCount; b < bucketVertices.size(); b++) bucketVertices[0] += bucketVertices[b];
+    bucketVertices.resize(bucketCount, 0);
+
+    std::vector<float> positions(numV * 3), normals(numVn * 3), texcoords(numVt * 2);
+    std::vector<float*> cursors(bucketCount);
+    out.meshes.resize(bucketCount);
+    for (size_t b = 0; b < bucketCount; b++) {
+        out.meshes[b].vertexCount = bucketVertices[b];
+        out.meshes[b].vertices.resize(bucketVertices[b] * OBJ_VERTEX_STRIDE);
+        cursors[b] = out.meshes[b].vertices.data();
+    }
+
+    // Passagem 2: preencher atributos e escrever vertices interleaved no bucket final
+    size_t readV = 0, readVn = 0, readVt = 0;
+    std::vector<Corner> corners;
+    corners.reserve(16);
+    size_t nextUsemtl = 0;
+    currentMaterial = -1;
+
+    for (const char* line = data; line < end; ) {
+        const char* eol = lineEnd(line, end);
+        const char* p = skipSpaces(line, eol);
+        if (p < eol) {
+            if (isKeyword(p, eol, "v", 1)) {
+                p += 1;
+                float* dst = &positions[3 * readV++];
+                dst[0] = parseFloat(p, eol); dst[1] = parseFloat(p, eol); dst[2] = parseFloat(p, eol);
+            } else if (isKeyword(p, eol, "vn", 2)) {
+                p += 2;
+                float* dst = &normals[3 * readVn++];
+                dst[0] = parseFloat(p, eol); dst[1] = parseFloat(p, eol); dst[2] = parseFloat(p, eol);
+            } else if (isKeyword(p, eol, "vt", 2)) {
+                p += 2;
+                float* dst = &texcoords[2 * readVt++];
+                dst[0] = parseFloat(p, eol); dst[1] = parseFloat(p, eol);
+            } else if (isKeyword(p, eol, "f", 1)) {
+                p += 1;
+                corners.clear();
+                Corner c;
+                while (parseCorner(p, eol, c)) {
+                    c.v = resolveIndex(c.v, readV);
+                    c.vt = resolveIndex(c.vt, readVt);
+                    c.vn = resolveIndex(c.vn, readVn);
+                    if (c.v < 0 || (size_t)c.v >= numV) { err = "Invalid vertex index in face"; return false; }
+                    if ((size_t)c.vt >= numVt) c.vt = -1;
+                    if ((size_t)c.vn >= numVn) c.vn = -1;
+                    corners.push_back(c);
+                }
+                writePolygon(corners, positions, normals, texcoords, cursors[bucketFor(currentMaterial, bucketCount)]);
+            } else if (isKeyword(p, eol, "usemtl", 6)) {
+                // Reutiliza a resolucao da passagem 1 para que as contagens batam certo
+                currentMaterial = usemtlIds[nextUsemtl++];
+            }
+        }
+        line = eol + 1;
+    }
+    return true;
+}
+
+bool ObjParser::loadParallel(const std::string& path, const std::string& basePath, ObjData& out, std::string& err, unsigned threads) {
+    VfsFile file;
+    if (!Vfs::read(path, file)) { err = "Cannot open " + path; return false; }
+    return parseParallel(file.data(), file.size(), basePath, out, err, threads);
+}
+
+bool ObjParser::parseParallel(const char* data, size_t size, const std::string& basePath, ObjData& out, std::string& err, unsigned threads,
+                              JobSystem* system) {
+    JobSystem& pool = system ? *system : jobs();
+    if (threads == 0) {
+        if (size < PARALLEL_MIN_BYTES) return parseStreaming(data, size, basePath, out, err);
+        threads = pool.concurrency();
+    }
+
+    out = ObjData();
+    out.sourceBytes = size;
+    const char* end = data + size;
+
+    // Cortes alinhados ao fim de linha mais proximo
+    std::vector<ObjChunk> chunks(threads);
+    const char* cursor = data;
+    for (unsigned i = 0; i < threads; i++) {
+        chunks[i].begin = cursor;
+        const char* cut = (i + 1 == threads) ? end : std::max(cursor, data + size * (i + 1) / threads);
+        if (cut < end) cut = lineEnd(cut, end) + 1;
+        chunks[i].end = std::min(cut, end);
+        cursor = chunks[i].end;
+    }
+
+    // Fase 1 (paralela): tokenizar cada chunk com indices locais
+    forEachChunk(pool, chunks.size(), [&](size_t i) { tokenizeChunk(chunks[i]); });
+
+    // Fase 2 (serie): prefix-sum dos atributos, materiais e offsets de escrita por bucket
+    std::map<std::string, int> materialMap;
+    std::string warn;
+    size_t numV = 0, numVt = 0, numVn = 0;
+    for (auto& chunk : chunks) {
+        chunk.vOffset = numV; chunk.vtOffset = numVt; chunk.vnOffset = numVn;
+        numV += chunk.positions.size() / 3;
+        numVt += chunk.texcoords.size() / 2;
+        numVn += chunk.normals.size() / 3;
+        for (const auto& lib : chunk.mtllibs) loadMaterialLibrary(basePath + lib, out.materials, materialMap, warn);
+    }
+
+    size_t bucketCount = std::max((size_t)1, out.materials.size());
+    std::vector<size_t> bucketVertices(bucketCount, 0);
+    int currentMaterial = -1;
+    for (auto& chunk : chunks) {
+        chunk.bucketStart = bucketVertices;
+        chunk.runMaterials.resize(chunk.runNames.size());
+        for (size_t r = 0; r < chunk.runNames.size(); r++) {
+            if (r > 0) currentMaterial = lookupMaterial(materialMap, chunk.runNames[r]);
+            chunk.runMaterials[r] = currentMaterial;
+            bucketVertices[bucketFor(currentMaterial, bucketCount)] += chunk.runVertices[r];
+        }
+    }
+
+    out.meshes.resize(bucketCount);
+    for (size_t b = 0; b < bucketCount; b++) {
+        out.meshes[b].vertexCount = bucketVertices[b];
+        out.meshes[b].vertices.resize(bucketVertices[b] * OBJ_VERTEX_STRIDE);
+    }
+
+    // Fase 3 (paralela): juntar atributos nos arrays globais e depois expandir as faces
+    std::vector<float> positions(numV * 3), normals(numVn * 3), texcoords(numVt * 2);
+    forEachChunk(pool, chunks.size(), [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.vOffset * 3);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.vnOffset * 3);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), texcoords.begin() + chunk.vtOffset * 2);
+    });
+    forEachChunk(pool, chunks.size(), [&](size_t i) { expandChunk(chunks[i], out, positions, normals, texcoords); });
+
+    for (const auto& chunk : chunks) {
+        if (!chunk.err.empty()) { err = chunk.err; return false; }
+    }
+    return true;
+}
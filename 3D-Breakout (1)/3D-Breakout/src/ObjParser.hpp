@@ -0,0 +1,45 @@
+#ifndef OBJPARSER_HPP
+#define OBJPARSER_HPP
+
+#include <string>
+#include <vector>
+
+#include "common/tiny_obj_loader.h"
+#include "jobs.h"
+
+// Layout interleaved por vertice: posicao(3) normal(3) uv(2) cor(3)
+const int OBJ_VERTEX_STRIDE = 11;
+
+// Abaixo disto o custo de dividir e juntar os chunks nao compensa
+const size_t PARALLEL_MIN_BYTES = 4 * 1024 * 1024;
+
+struct ObjMeshData {
+    std::vector<float> vertices;
+    size_t vertexCount = 0;
+};
+
+struct ObjData {
+    std::vector<tinyobj::material_t> materials;
+    std::vector<ObjMeshData> meshes;    // um bucket por material (minimo 1)
+    size_t sourceBytes = 0;
+};
+
+class ObjParser {
+public:
+    // Caminho original: tinyobj::LoadObj + conversao attrib_t/shape_t
+    static bool loadTinyObj(const std::string& path, const std::string& basePath, ObjData& out, std::string& err);
+
+    // Os caminhos load* leem atraves do Vfs (arquivo .pak mapeado ou ficheiros soltos)
+    // Parser em streaming: uma passagem para contar, outra para escrever directamente nos buffers finais
+    static bool loadStreaming(const std::string& path, const std::string& basePath, ObjData& out, std::string& err);
+    static bool parseStreaming(const char* data, size_t size, const std::string& basePath, ObjData& out, std::string& err);
+
+    // Parser multithread: chunks alinhados a linhas tokenizados em paralelo (jobs) e juntos com prefix-sum.
+    // threads e o numero de chunks; 0 escolhe automaticamente e usa o caminho em streaming para ficheiros
+    // pequenos. system == nullptr usa o jobs() global
+    static bool loadParallel(const std::string& path, const std::string& basePath, ObjData& out, std::string& err, unsigned threads = 0);
+    static bool parseParallel(const char* data, size_t size, const std::string& basePath, ObjData& out, std::string& err, unsigned threads = 0,
+                              JobSystem* system = nullptr);
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "alloc_hook.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Inicializacao constante: pode ser usado antes dos construtores estaticos e no fim das threads
+thread_local AllocCounters counters = { 0, 0, 0 };
+
+} // namespace
+
+bool AllocHook::enabled() {
+#ifdef BREAKOUT_NO_ALLOC_HOOK
+    return false;
+#else
+    return true;
+#endif
+}
+
+const AllocCounters& AllocHook::thisThread() {
+    return counters;
+}
+
+#ifndef BREAKOUT_NO_ALLOC_HOOK
+
+namespace {
+
+void* countedAlloc(size_t size) {
+    counters.allocations++;
+    counters.bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+void* countedAlignedAlloc(size_t size, size_t align) {
+    counters.allocations++;
+    counters.bytes += size;
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc pede um tamanho multiplo do alinhamento
+    return std::aligned_alloc(align, ((size ? size : 1) + align - 1) & ~(align - 1));
+#endif
+}
+
+void countedFree(void* p) {
+    if (!p) return;
+    counters.frees++;
+    std::free(p);
+}
+
+void countedAlignedFree(void* p) {
+    if (!p) return;
+    counters.frees++;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t align) {
+    void* p = countedAlignedAlloc(size, (size_t)align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    void* p = countedAlignedAlloc(size, (size_t)align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, (size_t)align); }
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedAlignedFree(p); }
+
+#endif
@@ -0,0 +1,120 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "game.h"
+
+namespace {
+
+const float HISTOGRAM_BUCKET_MS = 0.5f;
+const int HISTOGRAM_BUCKETS = 100;    // 0-50 ms; o ultimo bucket acumula o resto
+// Amostras reservadas por segundo nos benchmarks por tempo: acima disto o buffer enche e o
+// benchmark acaba mais cedo em vez de realocar a meio da medicao
+const size_t MAX_SAMPLED_FPS = 10000;
+
+float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) return 0.0f;
+    size_t index = std::min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5f));
+    return sorted[index];
+}
+
+// O nome do GL_RENDERER vem do driver e pode ter aspas ou barras
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if ((unsigned char)c < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", (unsigned)(unsigned char)c);
+            out += code;
+        }
+        else out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+Benchmark::Benchmark()
+    : active(false), threaded(false), sphereMode("impostor"), sphereCount(1), roomLighting("baked"), reportPath("bench_report.json"), targetFrames(0), targetSeconds(0.0), frameCount(0),
+      totalDrawCalls(0), totalTriangles(0), totalHeapAllocs(0), framesWithAllocs(0), latencyStats() {}
+
+bool Benchmark::parse(const std::string& arg) {
+    if (arg.empty()) return false;
+    if (arg.back() == 's') targetSeconds = std::atof(arg.c_str());
+    else targetFrames = (unsigned)std::atoi(arg.c_str());
+    active = targetSeconds > 0.0 || targetFrames > 0;
+    if (active) frameTimes.reserve(targetFrames ? targetFrames : (size_t)std::ceil(targetSeconds * MAX_SAMPLED_FPS));
+    return active;
+}
+
+bool Benchmark::finished(double elapsedSeconds) const {
+    if (targetFrames) return frameCount >= targetFrames + WARMUP_FRAMES;
+    return elapsedSeconds >= targetSeconds || frameTimes.size() == frameTimes.capacity();
+}
+
+void Benchmark::cameraAt(unsigned frame, float& yaw, float& pitch) const {
+    // Lissajous lento sobre a sala: periodos de 20 s e 13 s a 60 fps
+    float t = frame * FIXED_DT;
+    float yawMid = (CAMERA_YAW_MIN + CAMERA_YAW_MAX) * 0.5f, yawAmp = (CAMERA_YAW_MAX - CAMERA_YAW_MIN) * 0.5f;
+    float pitchMid = (CAMERA_PITCH_MIN + CAMERA_PITCH_MAX) * 0.5f, pitchAmp = (CAMERA_PITCH_MAX - CAMERA_PITCH_MIN) * 0.5f;
+    yaw = yawMid + yawAmp * 0.95f * std::sin(t * 2.0f * 3.14159265f / 20.0f);
+    pitch = pitchMid + pitchAmp * 0.95f * std::sin(t * 2.0f * 3.14159265f / 13.0f);
+}
+
+void Benchmark::recordFrame(float frameMs, unsigned drawCalls, unsigned long long triangles, unsigned long long heapAllocs) {
+    frameCount++;
+    if (frameCount <= (unsigned)WARMUP_FRAMES) return;
+    frameTimes.push_back(frameMs);
+    totalDrawCalls += drawCalls;
+    totalTriangles += triangles;
+    totalHeapAllocs += heapAllocs;
+    if (heapAllocs) framesWithAllocs++;
+}
+
+bool Benchmark::writeReport(const std::string& renderer, double elapsedSeconds) const {
+    std::vector<float> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+
+    double sum = 0.0;
+    for (float ms : sorted) sum += ms;
+    double avg = n ? sum / n : 0.0;
+
+    std::vector<unsigned> histogram(HISTOGRAM_BUCKETS, 0);
+    for (float ms : frameTimes) histogram[std::min(HISTOGRAM_BUCKETS - 1, (int)(ms / HISTOGRAM_BUCKET_MS))]++;
+
+    FILE* file = std::fopen(reportPath.c_str(), "w");
+    if (!file) { std::cerr << "Benchmark: cannot write " << reportPath << std::endl; return false; }
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"renderer\": \"%s\",\n", jsonEscape(renderer).c_str());
+    std::fprintf(file, "  \"render_thread\": %s,\n", threaded ? "true" : "false");
+    std::fprintf(file, "  \"spheres\": { \"mode\": \"%s\", \"count\": %u },\n", sphereMode, sphereCount);
+    std::fprintf(file, "  \"room_lighting\": \"%s\",\n", roomLighting);
+    std::fprintf(file, "  \"frames\": %zu,\n  \"warmup_frames\": %d,\n  \"elapsed_s\": %.3f,\n", n, WARMUP_FRAMES, elapsedSeconds);
+    std::fprintf(file, "  \"frame_ms\": { \"min\": %.4f, \"avg\": %.4f, \"max\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"p999\": %.4f },\n",
+                 n ? sorted.front() : 0.0f, avg, n ? sorted.back() : 0.0f, percentile(sorted, 0.5f), percentile(sorted, 0.9f),
+                 percentile(sorted, 0.95f), percentile(sorted, 0.99f), percentile(sorted, 0.999f));
+    std::fprintf(file, "  \"fps_avg\": %.2f,\n", avg > 0.0 ? 1000.0 / avg : 0.0);
+    std::fprintf(file, "  \"draw_calls_per_frame\": %.2f,\n", n ? (double)totalDrawCalls / n : 0.0);
+    std::fprintf(file, "  \"triangles_per_frame\": %.1f,\n", n ? (double)totalTriangles / n : 0.0);
+    std::fprintf(file, "  \"input_latency_ms\": { \"samples\": %zu, \"median\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+                 latencyStats.count, latencyStats.median, latencyStats.p99, latencyStats.max);
+    std::fprintf(file, "  \"heap_allocs\": { \"total\": %llu, \"frames_with_allocs\": %u },\n", totalHeapAllocs, framesWithAllocs);
+    std::fprintf(file, "  \"histogram\": { \"bucket_ms\": %.2f, \"counts\": [", HISTOGRAM_BUCKET_MS);
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) std::fprintf(file, "%s%u", i ? ", " : "", histogram[i]);
+    std::fprintf(file, "] }\n}\n");
+    std::fclose(file);
+
+    std::cout << "Benchmark: " << n << " frames, avg " << avg << " ms, p99 " << percentile(sorted, 0.99f)
+              << " ms -> " << reportPath << std::endl;
+    if (totalHeapAllocs)
+        std::cout << "Benchmark: " << totalHeapAllocs << " heap allocations in " << framesWithAllocs
+                  << " frames after warmup (expected 0)" << std::endl;
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "btex.h"
+
+#include <cstring>
+
+namespace {
+
+void unpack565(uint16_t c, uint8_t* out) {
+    out[0] = (uint8_t)(((c >> 11) & 31) * 255 / 31);
+    out[1] = (uint8_t)(((c >> 5) & 63) * 255 / 63);
+    out[2] = (uint8_t)((c & 31) * 255 / 31);
+    out[3] = 255;
+}
+
+void decodeColorBlock(const uint8_t* block, bool forceFourColor, uint8_t palette[4][4], uint32_t& indices) {
+    uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+    uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+    indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+    for (int ch = 0; ch < 3; ch++) {
+        if (c0 > c1 || forceFourColor) {
+            palette[2][ch] = (uint8_t)((2 * palette[0][ch] + palette[1][ch]) / 3);
+            palette[3][ch] = (uint8_t)((palette[0][ch] + 2 * palette[1][ch]) / 3);
+        } else {
+            palette[2][ch] = (uint8_t)((palette[0][ch] + palette[1][ch]) / 2);
+            palette[3][ch] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = (c0 > c1 || forceFourColor) ? 255 : 0;
+}
+
+void decodeAlphaBlock(const uint8_t* block, uint8_t alpha[16]) {
+    uint8_t a[8];
+    a[0] = block[0];
+    a[1] = block[1];
+    if (a[0] > a[1]) {
+        for (int i = 2; i < 8; i++) a[i] = (uint8_t)(((8 - i) * a[0] + (i - 1) * a[1]) / 7);
+    } else {
+        for (int i = 2; i < 6; i++) a[i] = (uint8_t)(((6 - i) * a[0] + (i - 1) * a[1]) / 5);
+        a[6] = 0;
+        a[7] = 255;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++) alpha[i] = a[(bits >> (3 * i)) & 7];
+}
+
+} // namespace
+
+bool BtexImage::parse(const char* data, size_t size) {
+    mips.clear();
+    if (size < sizeof(BtexHeader)) return false;
+    BtexHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BTEX_MAGIC, 4) != 0 || header.format > BTEX_BC3) return false;
+
+    format = header.format;
+    size_t offset = sizeof(BtexHeader);
+    for (uint32_t i = 0; i < header.levels; i++) {
+        if (offset + sizeof(BtexLevel) > size) return false;
+        BtexLevel level;
+        std::memcpy(&level, data + offset, sizeof(level));
+        offset += sizeof(BtexLevel);
+        if (offset + level.size > size || level.size != levelSize(format, level.width, level.height)) return false;
+        mips.push_back(BtexMip{ level.width, level.height, reinterpret_cast<const uint8_t*>(data + offset), level.size });
+        offset += level.size;
+    }
+    return !mips.empty();
+}
+
+size_t BtexImage::levelSize(uint32_t format, uint32_t width, uint32_t height) {
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+    if (format == BTEX_BC1) return blocks * 8;
+    if (format == BTEX_BC3) return blocks * 16;
+    return (size_t)width * height * 4;
+}
+
+void BtexImage::decodeToRgba(uint32_t format, const uint8_t* src, uint32_t width, uint32_t height, std::vector<uint8_t>& rgba) {
+    rgba.resize((size_t)width * height * 4);
+    if (format == BTEX_RGBA8) { std::memcpy(rgba.data(), src, rgba.size()); return; }
+
+    size_t blockBytes = (format == BTEX_BC3) ? 16 : 8;
+    for (uint32_t by = 0; by < (height + 3) / 4; by++) {
+        for (uint32_t bx = 0; bx < (width + 3) / 4; bx++, src += blockBytes) {
+            uint8_t alpha[16];
+            const uint8_t* colorBlock = src;
+            if (format == BTEX_BC3) { decodeAlphaBlock(src, alpha); colorBlock = src + 8; }
+
+            uint8_t palette[4][4];
+            uint32_t indices;
+            decodeColorBlock(colorBlock, format == BTEX_BC3, palette, indices);
+            for (int p = 0; p < 16; p++) {
+                uint32_t x = bx * 4 + (p & 3), y = by * 4 + (p >> 2);
+                if (x >= width || y >= height) continue;
+                uint8_t* dst = &rgba[((size_t)y * width + x) * 4];
+                std::memcpy(dst, palette[(indices >> (2 * p)) & 3], 4);
+                if (format == BTEX_BC3) dst[3] = alpha[p];
+            }
+        }
+    }
+}
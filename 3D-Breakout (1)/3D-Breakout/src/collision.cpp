@@ -0,0 +1,114 @@
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "frame_arena.h"
+
+namespace {
+
+const size_t BROAD_PHASE_GRAIN = 2048;
+const size_t MAX_NEAR_BRICKS = 64;    // a bola so toca em poucos; acima disto volta ao caminho em serie
+
+bool nearBox(float ballX, float ballY, float reach, const Transform& box) {
+    return std::abs(ballX - box.position.x) <= box.size.x * 0.5f + reach && std::abs(ballY - box.position.y) <= box.size.y * 0.5f + reach;
+}
+
+// Resposta pela ordem de criacao dos tijolos (indice da entidade), a mesma do vector de
+// tijolos original: com a bola a tocar em dois no mesmo passo e o primeiro que a reflecte.
+// A ordem densa nao serve, porque destruir troca o ultimo elemento para a posicao livre
+int resolveNear(Ball& ball, Registry& world, Entity* near, size_t count, BrickHitFunction onHit, void* context) {
+    std::sort(near, near + count, [](Entity a, Entity b) { return entityIndex(a) < entityIndex(b); });
+    ComponentPool<Transform>& boxes = world.pool<Transform>();
+    const ComponentPool<Breakable>& breakable = world.pool<Breakable>();
+    int destroyed = 0;
+    for (size_t i = 0; i < count; i++) {
+        Entity e = near[i];
+        if (!breakable.has(e) || !Collision::ballBrick(ball, boxes.get(e))) continue;
+        if (onHit) onHit(context, world, e);
+        world.destroy(e);
+        destroyed++;
+    }
+    return destroyed;
+}
+
+// Fase larga em serie. So com mais de MAX_NEAR_BRICKS perto da bola a lista vai para a arena
+// do frame
+int resolveBricks(Ball& ball, Registry& world, float reach, BrickHitFunction onHit, void* context) {
+    const ComponentPool<Transform>& boxes = world.pool<Transform>();
+    Entity nearBricks[MAX_NEAR_BRICKS];
+    size_t count = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (!nearBox(ball.position.x, ball.position.y, reach, boxes.data()[i])) continue;
+        if (count == MAX_NEAR_BRICKS) {
+            ArenaVector<Entity> near{ ArenaAllocator<Entity>(frameArena().current()) };
+            near.assign(nearBricks, nearBricks + count);
+            for (; i < boxes.size(); i++) {
+                if (nearBox(ball.position.x, ball.position.y, reach, boxes.data()[i])) near.push_back(boxes.entities()[i]);
+            }
+            return resolveNear(ball, world, near.data(), near.size(), onHit, context);
+        }
+        nearBricks[count++] = boxes.entities()[i];
+    }
+    return resolveNear(ball, world, nearBricks, count, onHit, context);
+}
+
+} // namespace
+
+bool Collision::ballPaddle(const Ball& ball, const Paddle& paddle) {
+    bool colX = ball.position.x + ball.radius >= paddle.position.x - paddle.size.x/2 && paddle.position.x + paddle.size.x/2 >= ball.position.x - ball.radius;
+    bool colY = ball.position.y - ball.radius <= paddle.position.y + paddle.size.y/2 && ball.position.y + ball.radius >= paddle.position.y - paddle.size.y/2;
+    return colX && colY && ball.velocity.y < 0;
+}
+
+bool Collision::ballBrick(Ball& ball, const Transform& brick) {
+    glm::vec2 ballCenter(ball.position.x, ball.position.y);
+    glm::vec2 halfExtents(brick.size.x / 2.0f, brick.size.y / 2.0f);
+    glm::vec2 brickCenter(brick.position.x, brick.position.y);
+    glm::vec2 diff = ballCenter - brickCenter;
+    glm::vec2 clamped = glm::clamp(diff, -halfExtents, halfExtents);
+    glm::vec2 closest = brickCenter + clamped;
+    diff = closest - ballCenter;
+    if (glm::length(diff) < ball.radius) {
+        glm::vec2 compass[] = { {0,1}, {1,0}, {0,-1}, {-1,0} };
+        float max = 0.0f; int best = -1;
+        glm::vec2 n_diff = glm::normalize(-diff);
+        for (int i=0; i<4; i++) { float dot = glm::dot(n_diff, compass[i]); if (dot > max) { max = dot; best = i; } }
+        if (best == 1 || best == 3) { ball.reverseX(); float pen = ball.radius - std::abs(diff.x); ball.position.x += (best == 1) ? pen : -pen; }
+        else { ball.reverseY(); float pen = ball.radius - std::abs(diff.y); ball.position.y += (best == 0) ? pen : -pen; }
+        return true;
+    }
+    return false;
+}
+
+int Collision::resolve(Ball& ball, const Paddle& paddle, Registry& world, float bounceSpeed, JobSystem& pool,
+                       BrickHitFunction onHit, void* context) {
+    if (ballPaddle(ball, paddle)) {
+        ball.reverseY();
+        float hitPoint = (ball.position.x - paddle.position.x) / (paddle.size.x / 2.0f);
+        ball.velocity.x = bounceSpeed * hitPoint * 1.5f;
+        ball.position.y = paddle.position.y + (paddle.size.y / 2.0f) + ball.radius;
+    }
+    // Caixas a menos de um raio extra da bola: cobre o deslocamento das correcoes de
+    // penetracao durante a resposta
+    float reach = ball.radius * 2.0f;
+    ComponentPool<Transform>& boxes = world.pool<Transform>();
+    if (boxes.size() < PARALLEL_MIN_BRICKS) return resolveBricks(ball, world, reach, onHit, context);
+
+    Entity nearBricks[MAX_NEAR_BRICKS];
+    std::atomic<size_t> nearCount(0);
+    float ballX = ball.position.x, ballY = ball.position.y;
+    const Transform* boxData = boxes.data();
+    const Entity* entities = boxes.entities();
+    pool.parallelFor(boxes.size(), BROAD_PHASE_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!nearBox(ballX, ballY, reach, boxData[i])) continue;
+            size_t slot = nearCount.fetch_add(1, std::memory_order_relaxed);
+            if (slot < MAX_NEAR_BRICKS) nearBricks[slot] = entities[i];
+        }
+    });
+
+    size_t count = nearCount.load(std::memory_order_relaxed);
+    if (count > MAX_NEAR_BRICKS) return resolveBricks(ball, world, reach, onHit, context);
+    return resolveNear(ball, world, nearBricks, count, onHit, context);
+}
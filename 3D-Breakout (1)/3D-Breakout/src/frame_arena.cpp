@@ -0,0 +1,77 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+size_t alignUp(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+char* allocateBlock(size_t bytes) {
+    void* block = std::malloc(bytes);
+    if (!block) throw std::bad_alloc();
+    return static_cast<char*>(block);
+}
+
+} // namespace
+
+LinearArena::LinearArena(size_t capacity)
+    : block(allocateBlock(capacity)), size(capacity), offset(0), peak(0), overflowBytes(0), overflow(nullptr) {}
+
+LinearArena::~LinearArena() {
+    reset();
+    std::free(block);
+}
+
+void* LinearArena::allocate(size_t bytes, size_t align) {
+    // O bloco vem do malloc: alinhado a max_align_t, por isso alinhar o offset chega
+    size_t start = alignUp(offset, align);
+    if (start + bytes <= size) {
+        offset = start + bytes;
+        peak = std::max(peak, used());
+        return block + start;
+    }
+
+    // Cheio: bloco proprio com o cabecalho da lista antes dos dados
+    size_t header = alignUp(sizeof(Overflow), std::max(align, alignof(std::max_align_t)));
+    char* extra = allocateBlock(header + bytes);
+    Overflow* node = reinterpret_cast<Overflow*>(extra);
+    node->next = overflow;
+    overflow = node;
+    overflowBytes += bytes + align;
+    peak = std::max(peak, used());
+    return extra + header;
+}
+
+void LinearArena::reset() {
+    bool overflowed = overflow != nullptr;
+    while (overflow) {
+        Overflow* next = overflow->next;
+        std::free(overflow);
+        overflow = next;
+    }
+    overflowBytes = 0;
+    offset = 0;
+    if (overflowed) {
+        // Cresce uma vez para o pico (com folga) em vez de voltar a transbordar todos os frames
+        size_t grown = alignUp(peak + peak / 2, 4096);
+        std::free(block);
+        block = allocateBlock(grown);
+        size = grown;
+    }
+}
+
+FrameArena::FrameArena(size_t capacity) : arenas{ LinearArena(capacity), LinearArena(capacity) }, index(0) {}
+
+void FrameArena::beginFrame() {
+    index ^= 1;
+    arenas[index].reset();
+}
+
+FrameArena& frameArena() {
+    thread_local FrameArena arena;
+    return arena;
+}
@@ -0,0 +1,111 @@
+#include "frame_pacer.h"
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "trace.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+double wallSeconds() {
+    return Trace::nowNs() * 1e-9;
+}
+
+// Tempo de CPU do processo (todas as threads, user + kernel)
+double cpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime; u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// sleep_for acorda tarde (ate ~1-2 ms no Windows); o ultimo milissegundo e em yield
+void sleepUntil(double deadline) {
+    double remaining = deadline - wallSeconds();
+    if (remaining > 0.002) std::this_thread::sleep_for(std::chrono::microseconds((long long)((remaining - 0.001) * 1e6)));
+    while (wallSeconds() < deadline) std::this_thread::yield();
+}
+
+} // namespace
+
+FramePacer::FramePacer()
+    : idleThrottle(true), frameCap(0), redrawRequested(true), redrawFrames(0), wasAnimating(true), idleMode(false),
+      lastSampleWall(0.0), lastSampleCpu(0.0), frameDeadline(0.0), idle{ 0.0, 0.0, 0 }, active{ 0.0, 0.0, 0 } {}
+
+void FramePacer::accountTime() {
+    double wall = wallSeconds(), cpu = cpuSeconds();
+    if (lastSampleWall > 0.0) {
+        ModeStats& mode = idleMode ? idle : active;
+        mode.wallSeconds += wall - lastSampleWall;
+        mode.cpuSeconds += cpu - lastSampleCpu;
+    }
+    lastSampleWall = wall;
+    lastSampleCpu = cpu;
+}
+
+bool FramePacer::waitForWork(bool animating) {
+    accountTime();
+    if (!animating && wasAnimating) redrawFrames = IDLE_REDRAW_FRAMES;
+    wasAnimating = animating;
+
+    if (animating || !idleThrottle) {
+        idleMode = false;
+        active.frames++;
+        return true;
+    }
+
+    idleMode = true;
+    if (redrawFrames > 0) {
+        redrawFrames--;
+        idle.frames++;
+        return true;
+    }
+    // Os callbacks chamados dentro do wait pedem o redraw
+    if (!redrawRequested) glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+    if (!redrawRequested) return false;
+    redrawRequested = false;
+    redrawFrames = IDLE_REDRAW_FRAMES - 1;
+    idle.frames++;
+    return true;
+}
+
+void FramePacer::limitFrameRate(bool animating) {
+    if (frameCap <= 0 || !animating) { frameDeadline = 0.0; return; }
+    double period = 1.0 / frameCap;
+    double now = wallSeconds();
+    // Atrasado mais de um frame (ou primeiro frame): recomeca o ritmo em vez de acelerar para recuperar
+    if (frameDeadline <= 0.0 || now - frameDeadline > period) {
+        frameDeadline = now + period;
+        return;
+    }
+    sleepUntil(frameDeadline);
+    frameDeadline += period;
+}
+
+void FramePacer::printReport() const {
+    if (idle.wallSeconds > 0.0) {
+        std::printf("Idle: %.1f s, %llu frames (%.1f frames/min), CPU %.1f%%\n", idle.wallSeconds, (unsigned long long)idle.frames,
+                    idle.frames * 60.0 / idle.wallSeconds, 100.0 * idle.cpuSeconds / idle.wallSeconds);
+    }
+    if (active.wallSeconds > 0.0) {
+        std::printf("Play: %.1f s, %llu frames (%.1f fps), CPU %.1f%%\n", active.wallSeconds, (unsigned long long)active.frames,
+                    active.frames / active.wallSeconds, 100.0 * active.cpuSeconds / active.wallSeconds);
+    }
+}
@@ -0,0 +1,42 @@
+#include "frustum.h"
+
+#include <cmath>
+
+Frustum::Frustum(const glm::mat4& clip) {
+    // glm e column-major: a linha i da matriz e (clip[0][i], clip[1][i], clip[2][i], clip[3][i])
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) rows[i] = glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+    planes[0] = rows[3] + rows[0];    // esquerda
+    planes[1] = rows[3] - rows[0];    // direita
+    planes[2] = rows[3] + rows[1];    // baixo
+    planes[3] = rows[3] - rows[1];    // cima
+    planes[4] = rows[3] + rows[2];    // perto
+    planes[5] = rows[3] - rows[2];    // longe
+    for (glm::vec4& p : planes) {
+        float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (length > 0.0f) p = p * (1.0f / length);
+    }
+}
+
+bool Frustum::intersects(const Aabb& box) const {
+    for (const glm::vec4& p : planes) {
+        // Vertice da caixa mais para dentro do plano: se esse esta fora, a caixa toda esta
+        float x = p.x >= 0.0f ? box.max.x : box.min.x;
+        float y = p.y >= 0.0f ? box.max.y : box.min.y;
+        float z = p.z >= 0.0f ? box.max.z : box.min.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool NormalCone::backfacing(const glm::vec3& eye, const Aabb& bounds) const {
+    if (cutoff > 1.0f) return false;
+    // Cada ponto p da caixa tem de ver o eixo a mais de 90 graus menos a abertura do cone:
+    // dot(p - eye, axis) >= cutoff * |p - eye|. Lado esquerdo no minimo da caixa (suporte),
+    // lado direito no maximo (centro + meia diagonal)
+    glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+    glm::vec3 half = (bounds.max - bounds.min) * 0.5f;
+    glm::vec3 toCenter = center - eye;
+    float nearest = glm::dot(toCenter, axis) - glm::dot(half, glm::abs(axis));
+    return nearest >= cutoff * (glm::length(toCenter) + glm::length(half));
+}
@@ -2,17 +2,43 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include "imgui.h" 
+#include "profiler.h"
+#include "collision.h"
+#include "geometry.h"
 
 const float INITIAL_BALL_SPEED = 12.0f;
 
+// Particulas no plano do tabuleiro (unidades do tabuleiro, segundos)
+const float PARTICLE_GRAVITY = 18.0f;
+const float PARTICLE_DRAG = 0.8f;
+const unsigned DEBRIS_PER_BRICK = 320;
+const unsigned SPARKS_PER_BRICK = 160;
+
+// Particulas GPU: a explosao cobre a zona dos tijolos (unidades do tabuleiro), a poeira a sala (mundo)
+const size_t GPU_EXPLOSION_PARTICLES = 1 << 20;
+const size_t GPU_DUST_PARTICLES = 1 << 15;
+const GpuParticleSettings EXPLOSION_SETTINGS = { glm::vec3(0.0f, 5.6f, 0.0f), glm::vec3(24.0f, 5.0f, 1.0f), glm::vec3(1.0f, 0.45f, 0.1f),
+                                                 30.0f, 0.25f, 2.5f, 18.0f, 0.6f, 0.0f, 1.0f, false };
+const GpuParticleSettings DUST_SETTINGS = { glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(14.0f, 6.0f, 14.0f), glm::vec3(0.2f, 0.8f, 1.0f),
+                                            0.15f, 0.03f, 8.0f, 0.0f, 0.5f, 0.3f, 2.0f, true };
+
+// Luz neon da sala, partilhada pelo shader principal, pelos impostores e pela luz cozinhada da sala
+const glm::vec3 NEON_LIGHT_POS = glm::vec3(0.0f, 2.0f, 4.0f);
+const glm::vec3 NEON_COLOR = glm::vec3(0.2f, 0.8f, 1.0f);
+const float BENCH_BALL_RADIUS = 0.3f;
+
 const glm::vec3 CFG_GAME_POS    = glm::vec3(0.6540f, -4.9120f, -0.9030f);
 const glm::vec3 CFG_GAME_ROT    = glm::vec3(-18.70f, -89.60f, -0.10f);
 const float     CFG_GAME_SCALE  = 0.0139f;
 const glm::vec3 CFG_CAM_POS     = glm::vec3(0.000f, -4.600f, -0.900f); 
 
 Game::Game(unsigned int width, unsigned int height) 
-    : state(GAME_MENU), width(width), height(height), score(0), lives(3), 
+    : state(GAME_MENU), width(width), height(height), autopilot(false), benchBalls(0), sphereImpostors(true), bakedRoomLighting(true),
+      impostorShader(nullptr), roomShader(nullptr), gpuUpdateShader(nullptr), gpuParticleShader(nullptr), explosion(nullptr), dust(nullptr),
+      levelClears(0), lastClearNs(0), gpuParticleTimeNs(0), explodedClears(0), score(0), lives(3), 
       arcadeModel(nullptr), useArcadeModel(true), 
       firstMouse(true), mouseCaptured(true),
       cameraYaw(43.0f), cameraPitch(-25.0f), 
@@ -26,7 +52,9 @@ Game::Game(unsigned int width, unsigned int height)
       gameLimitBottom(-10.0f)
 {
     std::cout << "Game constructor" << std::endl;
-    for (int i = 0; i < 1024; i++) keys[i] = false;
+    for (int i = 0; i < 1024; i++) keyDown[i] = false;
+    simTimeNs = 0;
+    renderAlpha = 0.0f;
     
     bricksPlanePosition = CFG_GAME_POS;
     bricksPlaneRotation = CFG_GAME_ROT;
@@ -36,19 +64,28 @@ Game::Game(unsigned int width, unsigned int height)
 }
 
 Game::~Game() {
-    delete ball; delete paddle; delete renderer; delete shader;
-    for (auto b : bricks) delete b;
+    delete ball; delete paddle; delete renderer; delete shader; delete particleShader; delete impostorShader; delete roomShader;
+    delete explosion; delete dust; delete gpuUpdateShader; delete gpuParticleShader;
     if (arcadeModel) delete arcadeModel;
 }
 
 void Game::init() {
     shader = new Shader("shaders/vertex.vert", "shaders/fragment.frag");
+    particleShader = new Shader("shaders/particle.vert", "shaders/particle.frag");
+    impostorShader = new Shader("shaders/sphere_impostor.vert", "shaders/sphere_impostor.frag");
+    roomShader = new Shader("shaders/room_unlit.vert", "shaders/room_unlit.frag");
+    gpuUpdateShader = new Shader("shaders/particle_update.vert", nullptr, GpuParticles::FEEDBACK_VARYINGS, 2);
+    gpuParticleShader = new Shader("shaders/particle_gpu.vert", "shaders/particle_gpu.frag");
+    explosion = new GpuParticles(GPU_EXPLOSION_PARTICLES, EXPLOSION_SETTINGS);
+    dust = new GpuParticles(GPU_DUST_PARTICLES, DUST_SETTINGS);
     renderer = new Renderer();
     renderer->init();
     
     ball = new Ball(glm::vec3(0.0f, -5.0f, 0.0f), glm::vec3(8.0f, INITIAL_BALL_SPEED, 0.0f), 0.5f);
     paddle = new Paddle(glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(4.0f, 0.6f, 1.2f), 20.0f);
     createBricks();
+    prevBallPosition = ball->position;
+    prevPaddlePosition = paddle->position;
     
     cameraPos = CFG_CAM_POS;
     cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -66,12 +103,33 @@ void Game::loadArcadeModel() {
     try {
         arcadeModel = new Model3D("arcade/uploads_files_2611707_ArcadeRoom_V1.obj", "arcade/");
         if (arcadeModel->load()) {
-            arcadeModel->setupMeshes();
+            // A sala e a luz nao se mexem: o difuso vai para a cor dos vertices antes do upload
+            auto bakeStart = std::chrono::steady_clock::now();
+            arcadeModel->bakeLighting(arcadeTransform(), NEON_LIGHT_POS, NEON_COLOR);
+            std::cout << "Lighting baked in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - bakeStart).count()
+                      << " ms" << std::endl;
+            size_t cpuBefore = arcadeModel->cpuMemoryBytes();
+            arcadeModel->setupMeshes(true);
             std::cout << "Model Loaded." << std::endl;
+            std::cout << "Model memory: CPU " << cpuBefore / 1024 << " KB -> " << arcadeModel->cpuMemoryBytes() / 1024
+                      << " KB, GPU " << arcadeModel->gpuMemoryBytes() / 1024 << " KB" << std::endl;
+            std::cout << "Textures: " << arcadeModel->textureMemoryBytes() / 1024 << " KB VRAM, "
+                      << arcadeModel->textureUploadTime() * 1000.0 << " ms decode+upload, "
+                      << arcadeModel->cookedTextureCount() << " cooked" << std::endl;
         }
     } catch (const std::exception& e) { std::cerr << "Error loading model: " << e.what() << std::endl; }
 }
 
+glm::mat4 Game::arcadeTransform() const {
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, arcadePosition);
+    model = glm::rotate(model, glm::radians(arcadeRotation.y), glm::vec3(0, 1, 0));
+    model = glm::rotate(model, glm::radians(arcadeRotation.x), glm::vec3(1, 0, 0));
+    model = glm::rotate(model, glm::radians(arcadeRotation.z), glm::vec3(0, 0, 1));
+    float autoScale = 15.0f / arcadeModel->getMaxDimension();
+    return glm::scale(model, arcadeScale * autoScale);
+}
+
 void Game::updateCamera() {
     glm::vec3 front;
     front.x = cos(glm::radians(cameraYaw)) * cos(glm::radians(cameraPitch));
@@ -81,31 +139,73 @@ void Game::updateCamera() {
     view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 }
 
-void Game::processInput(float dt) {
-    if (state == GAME_MENU && keys[GLFW_KEY_SPACE]) state = GAME_ACTIVE;
-    if ((state == GAME_WIN || state == GAME_LOSE) && keys[GLFW_KEY_R]) reset();
-    
-    if (state == GAME_ACTIVE) {
-        float halfPaddle = paddle->size.x / 2.0f;
+void Game::advance(uint64_t nowNs) {
+    const uint64_t stepNs = (uint64_t)(SIM_STEP * 1e9);
+    if (!simTimeNs || nowNs - simTimeNs > (uint64_t)(SIM_MAX_CATCHUP * 1e9)) simTimeNs = nowNs - std::min(nowNs, stepNs);
+
+    while (simTimeNs + stepNs <= nowNs) {
+        uint64_t stepEnd = simTimeNs + stepNs;
+        prevBallPosition = ball->position;
+        prevPaddlePosition = paddle->position;
+
+        if (autopilot && state == GAME_MENU) state = GAME_ACTIVE;
+        if (autopilot && (state == GAME_WIN || state == GAME_LOSE)) reset();
+
+        // O paddle anda com o estado das teclas em cada intervalo entre eventos;
+        // eventos mais antigos que o passo (entregues tarde) contam no inicio dele
+        uint64_t cursor = simTimeNs;
+        const InputEvent* event;
+        while ((event = input.peek()) && event->timeNs < stepEnd) {
+            uint64_t t = std::max(event->timeNs, cursor);
+            movePaddle((t - cursor) * 1e-9f);
+            cursor = t;
+            applyInput(*event);
+            input.pop();
+        }
+        movePaddle((stepEnd - cursor) * 1e-9f);
 
-        if (keys[GLFW_KEY_A]) {
-            paddle->moveLeft(dt, -20.0f);
-            if (paddle->position.x - halfPaddle < gameLimitLeft) {
-                paddle->position.x = gameLimitLeft + halfPaddle;
-            }
+        update((float)SIM_STEP);
+        simTimeNs = stepEnd;
+    }
+    renderAlpha = (float)(nowNs - simTimeNs) / (float)stepNs;
+}
+
+void Game::applyInput(const InputEvent& event) {
+    if (event.key < 0 || event.key >= 1024) return;
+    keyDown[event.key] = event.action == GLFW_PRESS;
+    if (event.action != GLFW_PRESS) return;
+    // Transicoes de estado no flanco: um toque rapido entre dois frames ja nao se perde
+    if (state == GAME_MENU && event.key == GLFW_KEY_SPACE) state = GAME_ACTIVE;
+    else if ((state == GAME_WIN || state == GAME_LOSE) && event.key == GLFW_KEY_R) reset();
+}
+
+void Game::movePaddle(float seconds) {
+    if (state != GAME_ACTIVE || seconds <= 0.0f) return;
+    float halfPaddle = paddle->size.x / 2.0f;
+    bool left = keyDown[GLFW_KEY_A], right = keyDown[GLFW_KEY_D];
+    if (autopilot) {
+        // Segue a bola com uma pequena zona morta, para o paddle nao oscilar
+        left = ball->position.x < paddle->position.x - 0.3f;
+        right = ball->position.x > paddle->position.x + 0.3f;
+    }
+
+    if (left) {
+        paddle->moveLeft(seconds, -20.0f);
+        if (paddle->position.x - halfPaddle < gameLimitLeft) {
+            paddle->position.x = gameLimitLeft + halfPaddle;
         }
+    }
 
-        if (keys[GLFW_KEY_D]) {
-            paddle->moveRight(dt, 20.0f);
-            if (paddle->position.x + halfPaddle > gameLimitRight) {
-                paddle->position.x = gameLimitRight - halfPaddle;
-            }
+    if (right) {
+        paddle->moveRight(seconds, 20.0f);
+        if (paddle->position.x + halfPaddle > gameLimitRight) {
+            paddle->position.x = gameLimitRight - halfPaddle;
         }
     }
-    updateCamera();
 }
 
 void Game::processMouseMovement(float xpos, float ypos) {
+    if (autopilot) return;
     if (firstMouse) { lastMouseX = xpos; lastMouseY = ypos; firstMouse = false; return; }
 
     float xoffset = xpos - lastMouseX;
@@ -116,19 +216,24 @@ void Game::processMouseMovement(float xpos, float ypos) {
     xoffset *= sensitivity;
     yoffset *= sensitivity;
 
-    cameraYaw   += xoffset;
-    cameraPitch += yoffset;
+    setCameraAngles(cameraYaw + xoffset, cameraPitch + yoffset);
+}
 
-    if (cameraPitch > -8.858f)  cameraPitch = -8.858f;
-    if (cameraPitch < -43.445f) cameraPitch = -43.445f;
+void Game::setCameraAngles(float yaw, float pitch) {
+    cameraYaw   = yaw;
+    cameraPitch = pitch;
 
-    if (cameraYaw < 7.677f)  cameraYaw = 7.677f;
-    if (cameraYaw > 78.484f) cameraYaw = 78.484f;
+    if (cameraPitch > CAMERA_PITCH_MAX) cameraPitch = CAMERA_PITCH_MAX;
+    if (cameraPitch < CAMERA_PITCH_MIN) cameraPitch = CAMERA_PITCH_MIN;
+
+    if (cameraYaw < CAMERA_YAW_MIN) cameraYaw = CAMERA_YAW_MIN;
+    if (cameraYaw > CAMERA_YAW_MAX) cameraYaw = CAMERA_YAW_MAX;
 
     updateCamera();
 }
 
 void Game::update(float dt) {
+    particles.update(dt, PARTICLE_GRAVITY, PARTICLE_DRAG);
     if (state == GAME_ACTIVE) {
         ball->update(dt);
         
@@ -152,41 +257,96 @@ void Game::update(float dt) {
             else { 
                 ball->position = glm::vec3(0.0f, -5.0f, 0.0f); 
                 ball->velocity = glm::vec3(8.0f, INITIAL_BALL_SPEED, 0.0f); 
+                prevBallPosition = ball->position;
             }
         }
         
-        checkCollisions();
-        bool allGone = true;
-        for (auto b : bricks) if (!b->destroyed) allGone = false;
-        if (allGone) state = GAME_WIN;
+        {
+            PROFILE_SCOPE(PROFILE_COLLISION);
+            checkCollisions();
+        }
+        if (world.pool<Breakable>().size() == 0) { state = GAME_WIN; levelClears++; lastClearNs = simTimeNs; }
     }
 }
 
-void Game::render() {
-    shader->use();
-    shader->setMat4("view", view);
-    shader->setMat4("projection", projection);
+bool Game::isAnimating() const {
+    if (state == GAME_ACTIVE || particles.alive() > 0) return true;
+    // As particulas da explosao vivem ate life * 1.5 (variacao de +-50% no spawn)
+    return levelClears && simTimeNs - lastClearNs < (uint64_t)(EXPLOSION_SETTINGS.life * 1.5f * 1e9);
+}
+
+void Game::snapshot(RenderSnapshot& out) const {
+    out.state = state;
+    out.width = width;
+    out.height = height;
+    out.score = score;
+    out.lives = lives;
+    out.view = view;
+    out.projection = projection;
+    out.cameraPos = cameraPos;
+    // Estado interpolado entre os dois ultimos passos da simulacao
+    out.paddlePosition = glm::mix(prevPaddlePosition, paddle->position, renderAlpha);
+    out.paddleSize = paddle->size;
+    out.simTimeNs = simTimeNs + (uint64_t)(renderAlpha * SIM_STEP * 1e9);
+    if (out.spheres.capacity() < 1 + benchBalls) out.spheres.reserve(1 + benchBalls);
+    out.spheres.clear();
+    out.spheres.push_back(glm::vec4(glm::mix(prevBallPosition, ball->position, renderAlpha), ball->radius));
+    // Bolas do benchmark: Lissajous deterministas no relogio da simulacao, dentro do campo
+    double t = out.simTimeNs * 1e-9;
+    for (unsigned i = 0; i < benchBalls; i++) {
+        double phase = i * 2.399963;
+        double speed = 0.3 + 0.2 * (i % 97) / 97.0;
+        out.spheres.push_back(glm::vec4((float)(13.0 * std::sin(t * speed + phase)), (float)(-0.25 + 9.0 * std::sin(t * speed * 1.37 + phase * 0.5)),
+                                        (float)(3.0 * std::sin(t * speed * 0.71 + phase * 2.0)), BENCH_BALL_RADIUS));
+    }
+    out.levelClears = levelClears;
+    if (out.particles.capacity() < particles.capacity()) out.particles.reserve(particles.capacity());
+    particles.pack(out.particles);
+    out.bricks.clear();
+    world.each<Transform, Tint>([&](Entity, const Transform& t, const Tint& tint) {
+        out.bricks.push_back(BrickInstance{ t.position, t.size, tint.color });
+    });
+}
+
+void Game::render(const RenderSnapshot& frame) const {
+    glViewport(0, 0, frame.width, frame.height);
+    {
+        PROFILE_SCOPE(PROFILE_SCENE_RENDER);
+        PROFILE_GPU(GPU_SCENE);
+        renderScene(frame);
+    }
+    {
+        PROFILE_SCOPE(PROFILE_IMGUI_BUILD);
+        renderUI(frame);
+    }
+}
 
-    glm::vec3 neonLightPos = glm::vec3(0.0f, 2.0f, 4.0f); 
-    shader->setVec3("lightPos", neonLightPos);
+void Game::renderScene(const RenderSnapshot& frame) const {
+    shader->use();
+    shader->setMat4("view", frame.view);
+    shader->setMat4("projection", frame.projection);
 
-    glm::vec3 neonColor = glm::vec3(0.2f, 0.8f, 1.0f); 
-    shader->setVec3("lightColor", neonColor);
+    shader->setVec3("lightPos", NEON_LIGHT_POS);
+    shader->setVec3("lightColor", NEON_COLOR);
 
-    shader->setVec3("viewPos", cameraPos);
+    shader->setVec3("viewPos", frame.cameraPos);
     
     if (useArcadeModel && arcadeModel && arcadeModel->loaded()) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, arcadePosition);
-        model = glm::rotate(model, glm::radians(arcadeRotation.y), glm::vec3(0, 1, 0));
-        model = glm::rotate(model, glm::radians(arcadeRotation.x), glm::vec3(1, 0, 0));
-        model = glm::rotate(model, glm::radians(arcadeRotation.z), glm::vec3(0, 0, 1));
-        float autoScale = 15.0f / arcadeModel->getMaxDimension();
-        model = glm::scale(model, arcadeScale * autoScale);
+        glm::mat4 model = arcadeTransform();
         
-        shader->setMat4("model", model);
-        shader->setVec3("objectColor", 1.0f, 1.0f, 1.0f);
-        arcadeModel->render(shader->ID);
+        // Luz cozinhada: so a textura vezes a cor do vertice; o Phong fica para o que se mexe
+        Shader* room = bakedRoomLighting ? roomShader : shader;
+        if (bakedRoomLighting) {
+            roomShader->use();
+            roomShader->setMat4("view", frame.view);
+            roomShader->setMat4("projection", frame.projection);
+        }
+        room->setMat4("model", model);
+        room->setVec3("objectColor", 1.0f, 1.0f, 1.0f);
+        Frustum frustum(frame.projection * frame.view * model);
+        glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(frame.cameraPos, 1.0f));
+        arcadeModel->render(room->ID, &frustum, &eye);
+        if (bakedRoomLighting) shader->use();
     }
     
     glm::mat4 gameBase = glm::mat4(1.0f);
@@ -205,48 +365,128 @@ void Game::render() {
     shader->setFloat("material.shininess", 64.0f);
     
     glm::mat4 m;
-    
-    m = glm::translate(gameBase, paddle->position); m = glm::scale(m, paddle->size);
+
+    m = Geometry::boardModelMatrix(gameBase, frame.paddlePosition, frame.paddleSize);
     shader->setMat4("model", m); shader->setVec3("objectColor", 0.3f, 0.7f, 1.0f);
-    glBindVertexArray(renderer->cubeVAO); glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(renderer->cubeVAO); glDrawArrays(GL_TRIANGLES, 0, 36); profiler().countDraw(36);
 
-    m = glm::translate(gameBase, ball->position); m = glm::scale(m, glm::vec3(ball->radius));
-    shader->setMat4("model", m); shader->setVec3("objectColor", 1.0f, 1.0f, 1.0f);
-    glBindVertexArray(renderer->sphereVAO); glDrawArrays(GL_TRIANGLES, 0, renderer->sphereVertexCount);
+    renderSpheres(frame, gameBase);
 
-    for (auto b : bricks) {
-        if (!b->destroyed) {
-            m = glm::translate(gameBase, b->position); m = glm::scale(m, b->size);
-            shader->setMat4("model", m); shader->setVec3("objectColor", b->color);
-            glBindVertexArray(renderer->cubeVAO); glDrawArrays(GL_TRIANGLES, 0, 36);
+    for (const BrickInstance& b : frame.bricks) {
+        m = Geometry::boardModelMatrix(gameBase, b.position, b.size);
+        shader->setMat4("model", m); shader->setVec3("objectColor", b.color);
+        glBindVertexArray(renderer->cubeVAO); glDrawArrays(GL_TRIANGLES, 0, 36); profiler().countDraw(36);
+    }
+
+    renderParticles(frame, gameBase);
+    renderGpuParticles(frame, gameBase);
+}
+
+// Malha: um draw de ~2.9k vertices por esfera. Impostor: um so draw instanciado de quads e a
+// esfera (profundidade e normal) sai do ray casting no fragment shader
+void Game::renderSpheres(const RenderSnapshot& frame, const glm::mat4& gameBase) const {
+    size_t count = frame.spheres.size();
+    if (!sphereImpostors) {
+        shader->setVec3("objectColor", 1.0f, 1.0f, 1.0f);
+        glBindVertexArray(renderer->sphereVAO);
+        for (const glm::vec4& s : frame.spheres) {
+            shader->setMat4("model", Geometry::boardModelMatrix(gameBase, glm::vec3(s), glm::vec3(s.w)));
+            glDrawArrays(GL_TRIANGLES, 0, renderer->sphereVertexCount); profiler().countDraw(renderer->sphereVertexCount);
         }
+        return;
     }
 
-    renderUI();
+    impostorShader->use();
+    impostorShader->setMat4("board", gameBase);
+    impostorShader->setMat4("view", frame.view);
+    impostorShader->setMat4("projection", frame.projection);
+    impostorShader->setMat4("viewInverse", glm::inverse(frame.view));
+    impostorShader->setFloat("boardScale", glm::length(glm::vec3(gameBase[0])));
+    impostorShader->setVec3("objectColor", 1.0f, 1.0f, 1.0f);
+    impostorShader->setVec3("lightPos", NEON_LIGHT_POS);
+    impostorShader->setVec3("lightColor", NEON_COLOR);
+    impostorShader->setVec3("viewPos", frame.cameraPos);
+    impostorShader->setVec3("material.diffuse", 0.0f, 0.0f, 0.0f);
+    impostorShader->setVec3("material.ambient", 0.3f, 0.1f, 0.4f);
+    impostorShader->setVec3("material.specular", 1.0f, 1.0f, 1.0f);
+    impostorShader->setFloat("material.shininess", 64.0f);
+
+    renderer->reserveImpostors(count);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->impostorInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, renderer->impostorCapacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec4), frame.spheres.data());
+    glBindVertexArray(renderer->impostorVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+    profiler().countDraw(6, (unsigned)count);
+    shader->use();
 }
 
-void Game::renderUI() {
+// Todas as particulas num so draw instanciado do cubo; o buffer e orfanado a cada frame
+void Game::renderParticles(const RenderSnapshot& frame, const glm::mat4& gameBase) const {
+    size_t count = std::min(frame.particles.size(), renderer->particleCapacity);
+    if (!count) return;
+
+    particleShader->use();
+    particleShader->setMat4("board", gameBase);
+    particleShader->setMat4("view", frame.view);
+    particleShader->setMat4("projection", frame.projection);
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->particleInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, renderer->particleCapacity * sizeof(ParticleInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(ParticleInstance), frame.particles.data());
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(renderer->particleVAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)count);
+    profiler().countDraw(36, (unsigned)count);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+// Um passo de transform feedback por efeito com o tempo que a simulacao andou desde o frame anterior
+void Game::renderGpuParticles(const RenderSnapshot& frame, const glm::mat4& gameBase) const {
+    float dt = 0.0f;
+    if (gpuParticleTimeNs && frame.simTimeNs > gpuParticleTimeNs) dt = std::min((float)((frame.simTimeNs - gpuParticleTimeNs) * 1e-9), (float)SIM_MAX_CATCHUP);
+    gpuParticleTimeNs = frame.simTimeNs;
+    if (frame.levelClears != explodedClears) {
+        explosion->burst(explosion->capacity());
+        explodedClears = frame.levelClears;
+    }
+
+    explosion->simulate(*gpuUpdateShader, dt);
+    explosion->draw(*gpuParticleShader, gameBase, frame.view, frame.projection, frame.height);
+    if (useArcadeModel && arcadeModel && arcadeModel->loaded()) {
+        dust->simulate(*gpuUpdateShader, dt);
+        dust->draw(*gpuParticleShader, glm::mat4(1.0f), frame.view, frame.projection, frame.height);
+    }
+}
+
+void Game::renderUI(const RenderSnapshot& frame) const {
     ImGui::SetNextWindowPos(ImVec2(20, 20));
     ImGui::Begin("HUD", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_AlwaysAutoResize);
     ImGui::SetWindowFontScale(1.5f);
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "SCORE: %05d", score);
-    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "LIVES: %d", lives);
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "SCORE: %05d", frame.score);
+    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "LIVES: %d", frame.lives);
     ImGui::End();
 
-    if (state != GAME_ACTIVE) {
-        ImGui::SetNextWindowPos(ImVec2(width/2.0f - 150, height/2.0f - 50));
+    profiler().renderOverlay();
+
+    if (frame.state != GAME_ACTIVE) {
+        ImGui::SetNextWindowPos(ImVec2(frame.width/2.0f - 150, frame.height/2.0f - 50));
         ImGui::Begin("MenuState", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
         ImGui::SetWindowFontScale(2.0f);
         
-        if (state == GAME_MENU) {
+        if (frame.state == GAME_MENU) {
             ImGui::Text("PRESS SPACE TO START");
         } 
-        else if (state == GAME_WIN) {
+        else if (frame.state == GAME_WIN) {
             ImGui::TextColored(ImVec4(0,1,0,1), "YOU WIN!");
             ImGui::SetWindowFontScale(1.0f);
             ImGui::Text("Press R to Restart");
         } 
-        else if (state == GAME_LOSE) {
+        else if (frame.state == GAME_LOSE) {
             ImGui::TextColored(ImVec4(1,0,0,1), "GAME OVER");
             ImGui::SetWindowFontScale(1.0f);
             ImGui::Text("Press R to Restart");
@@ -256,44 +496,25 @@ void Game::renderUI() {
 }
 
 void Game::updateResolution(unsigned int w, unsigned int h) { width = w; height = h; projection = glm::perspective(glm::radians(45.0f), (float)w/(float)h, 0.1f, 200.0f); }
-void Game::reset() { score = 0; lives = 3; state = GAME_MENU; ball->position = glm::vec3(0.0f, -5.0f, 0.0f); ball->velocity = glm::vec3(8.0f, INITIAL_BALL_SPEED, 0.0f); createBricks(); }
+void Game::reset() { score = 0; lives = 3; state = GAME_MENU; ball->position = glm::vec3(0.0f, -5.0f, 0.0f); ball->velocity = glm::vec3(8.0f, INITIAL_BALL_SPEED, 0.0f); prevBallPosition = ball->position; particles.clear(); createBricks(); }
 void Game::createBricks() {
     glm::vec3 colors[] = { {0,0.5,1}, {0,1,0}, {1,1,0}, {1,0.5,0}, {1,0,0} };
-    bricks.clear();
-    for (int y = 0; y < 5; y++) for (int x = 0; x < 10; x++) bricks.push_back(new Brick(glm::vec3(-11.0f + x * 2.4f, 8.0f - y * 1.2f, 0.0f), glm::vec3(2.0f, 0.8f, 1.0f), colors[y]));
-}
-void Game::checkCollisions() {
-    if (checkBallPaddleCollision()) {
-        ball->reverseY();
-        float hitPoint = (ball->position.x - paddle->position.x) / (paddle->size.x / 2.0f);
-        ball->velocity.x = INITIAL_BALL_SPEED * hitPoint * 1.5f; 
-        ball->position.y = paddle->position.y + (paddle->size.y / 2.0f) + ball->radius;
-    }
-    for (auto b : bricks) {
-        if (!b->destroyed && checkBallBrickCollision(b)) { b->destroyed = true; score += 10; }
+    world.clear();
+    for (int y = 0; y < 5; y++) for (int x = 0; x < 10; x++) {
+        Entity e = world.create();
+        world.add(e, Transform{ glm::vec3(-11.0f + x * 2.4f, 8.0f - y * 1.2f, 0.0f), glm::vec3(2.0f, 0.8f, 1.0f) });
+        world.add(e, Tint{ colors[y] });
+        world.add(e, Breakable{});
     }
 }
-bool Game::checkBallPaddleCollision() {
-    bool colX = ball->position.x + ball->radius >= paddle->position.x - paddle->size.x/2 && paddle->position.x + paddle->size.x/2 >= ball->position.x - ball->radius;
-    bool colY = ball->position.y - ball->radius <= paddle->position.y + paddle->size.y/2 && ball->position.y + ball->radius >= paddle->position.y - paddle->size.y/2;
-    return colX && colY && ball->velocity.y < 0;
+void Game::checkCollisions() {
+    score += 10 * Collision::resolve(*ball, *paddle, world, INITIAL_BALL_SPEED, jobs(), &Game::onBrickHit, this);
 }
-bool Game::checkBallBrickCollision(Brick* b) {
-    glm::vec2 ballCenter(ball->position.x, ball->position.y);
-    glm::vec2 halfExtents(b->size.x / 2.0f, b->size.y / 2.0f);
-    glm::vec2 brickCenter(b->position.x, b->position.y);
-    glm::vec2 diff = ballCenter - brickCenter;
-    glm::vec2 clamped = glm::clamp(diff, -halfExtents, halfExtents);
-    glm::vec2 closest = brickCenter + clamped;
-    diff = closest - ballCenter;
-    if (glm::length(diff) < ball->radius) {
-        glm::vec2 compass[] = { {0,1}, {1,0}, {0,-1}, {-1,0} };
-        float max = 0.0f; int best = -1;
-        glm::vec2 n_diff = glm::normalize(-diff);
-        for (int i=0; i<4; i++) { float dot = glm::dot(n_diff, compass[i]); if (dot > max) { max = dot; best = i; } }
-        if (best == 1 || best == 3) { ball->reverseX(); float pen = ball->radius - std::abs(diff.x); ball->position.x += (best == 1) ? pen : -pen; }
-        else { ball->reverseY(); float pen = ball->radius - std::abs(diff.y); ball->position.y += (best == 0) ? pen : -pen; }
-        return true;
-    }
-    return false;
+void Game::onBrickHit(void* context, Registry& world, Entity brick) {
+    Game* game = static_cast<Game*>(context);
+    const Transform& box = world.get<Transform>(brick);
+    const Tint* tint = world.pool<Tint>().find(brick);
+    glm::vec3 color = tint ? tint->color : glm::vec3(1.0f);
+    game->particles.emit(ParticleBurst{ box.position, box.size, color, DEBRIS_PER_BRICK, 9.0f, 0.18f, 1.6f });
+    game->particles.emit(ParticleBurst{ box.position, box.size * 0.5f, glm::vec3(1.0f, 0.9f, 0.6f), SPARKS_PER_BRICK, 22.0f, 0.05f, 0.5f });
 }
\ No newline at end of file
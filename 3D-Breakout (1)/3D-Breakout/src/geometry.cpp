@@ -0,0 +1,59 @@
+#include "geometry.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void Geometry::buildSphere(float radius, int sectors, int stacks, std::vector<float>& finalVertices) {
+    std::vector<float> vertices;
+    
+    for (int i = 0; i <= stacks; ++i) {
+        float stackAngle = M_PI / 2 - i * M_PI / stacks;
+        float xy = radius * cosf(stackAngle);
+        float z = radius * sinf(stackAngle);
+        
+        for (int j = 0; j <= sectors; ++j) {
+            float sectorAngle = j * 2 * M_PI / sectors;
+            float x = xy * cosf(sectorAngle);
+            float y = xy * sinf(sectorAngle);
+            
+            vertices.push_back(x);
+            vertices.push_back(y);
+            vertices.push_back(z);
+            
+            float nx = x / radius;
+            float ny = y / radius;
+            float nz = z / radius;
+            vertices.push_back(nx);
+            vertices.push_back(ny);
+            vertices.push_back(nz);
+        }
+    }
+    
+    finalVertices.clear();
+    for (int i = 0; i < stacks; ++i) {
+        int k1 = i * (sectors + 1);
+        int k2 = k1 + sectors + 1;
+        
+        for (int j = 0; j < sectors; ++j, ++k1, ++k2) {
+            if (i != 0) {
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + k1 * 6, vertices.begin() + k1 * 6 + 6);
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + k2 * 6, vertices.begin() + k2 * 6 + 6);
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + (k1 + 1) * 6, vertices.begin() + (k1 + 1) * 6 + 6);
+            }
+            
+            if (i != (stacks - 1)) {
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + (k1 + 1) * 6, vertices.begin() + (k1 + 1) * 6 + 6);
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + k2 * 6, vertices.begin() + k2 * 6 + 6);
+                finalVertices.insert(finalVertices.end(), 
+                    vertices.begin() + (k2 + 1) * 6, vertices.begin() + (k2 + 1) * 6 + 6);
+            }
+        }
+    }
+}
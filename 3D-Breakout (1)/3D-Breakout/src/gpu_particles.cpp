@@ -0,0 +1,116 @@
+#include "gpu_particles.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Estado de uma particula no VBO: posicao + vida, velocidade + tamanho
+const GLsizei STRIDE = 8 * sizeof(float);
+
+} // namespace
+
+const char* const GpuParticles::FEEDBACK_VARYINGS[2] = { "outPositionLife", "outVelocitySize" };
+
+GpuParticles::GpuParticles(size_t capacity, const GpuParticleSettings& settings)
+    : settings(settings), current(0), slots(capacity), spawnCursor(0), pendingSpawn(0), time(0.0f), seed(0x2545F491u),
+      active(settings.respawn) {
+    // Tudo a zero = tudo morto; com respawn nascem todas no primeiro passo
+    std::vector<float> zero(slots * 8, 0.0f);
+    glGenBuffers(2, buffers);
+    glGenVertexArrays(2, vaos);
+    for (int i = 0; i < 2; i++) {
+        glBindVertexArray(vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, slots * STRIDE, zero.data(), GL_DYNAMIC_COPY);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, STRIDE, (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, STRIDE, (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GpuParticles::~GpuParticles() {
+    glDeleteVertexArrays(2, vaos);
+    glDeleteBuffers(2, buffers);
+}
+
+void GpuParticles::burst(size_t count) {
+    pendingSpawn = std::min(slots, pendingSpawn + count);
+}
+
+void GpuParticles::simulate(Shader& update, float dt) {
+    if (pendingSpawn) active = true;
+    if (!active || dt <= 0.0f) return;
+    time += dt;
+    // Sem respawn, passada a vida maxima desde o ultimo nascimento ja nao ha nada vivo
+    float maxLife = settings.life * 1.5f;
+    if (!pendingSpawn && !settings.respawn && time > maxLife) { active = false; return; }
+
+    seed = seed * 1664525u + 1013904223u;
+    update.use();
+    update.setFloat("dt", dt);
+    update.setFloat("time", time);
+    update.setFloat("gravity", settings.gravity);
+    update.setFloat("drag", settings.drag);
+    update.setFloat("turbulence", settings.turbulence);
+    update.setInt("capacity", (int)slots);
+    update.setInt("spawnBegin", (int)spawnCursor);
+    update.setInt("spawnCount", (int)pendingSpawn);
+    update.setBool("respawn", settings.respawn);
+    update.setInt("seed", (int)seed);
+    update.setVec3("spawnCenter", settings.spawnCenter);
+    update.setVec3("spawnExtent", settings.spawnExtent);
+    update.setFloat("spawnSpeed", settings.speed);
+    update.setFloat("spawnSize", settings.size);
+    update.setFloat("spawnLife", settings.life);
+    if (pendingSpawn) {
+        spawnCursor = (spawnCursor + pendingSpawn) % slots;
+        pendingSpawn = 0;
+        // O relogio de "tudo morto" conta a partir do ultimo nascimento
+        time = 0.0f;
+    }
+
+    unsigned next = current ^ 1;
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(vaos[current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[next]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)slots);
+    glEndTransformFeedback();
+    profiler().countDraw(0);    // pontos: conta a chamada, nao ha triangulos
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(0);
+    current = next;
+}
+
+void GpuParticles::draw(Shader& render, const glm::mat4& space, const glm::mat4& view, const glm::mat4& projection, unsigned viewportHeight) const {
+    if (!active) return;
+    // Tamanho em pixeis = tamanho no mundo * altura * proj[1][1] / (2 w); a escala de space entra aqui
+    float spaceScale = glm::length(glm::vec3(space[0]));
+    render.use();
+    render.setMat4("space", space);
+    render.setMat4("view", view);
+    render.setMat4("projection", projection);
+    render.setFloat("pointScale", viewportHeight * projection[1][1] * 0.5f * spaceScale);
+    render.setFloat("fadeTime", std::max(settings.fadeTime, 1e-3f));
+    render.setVec3("color", settings.color);
+
+    // Aditivo e sem escrever profundidade: a ordem entre particulas nao importa
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(vaos[current]);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)slots);
+    profiler().countDraw(0);
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
@@ -0,0 +1,143 @@
+#include "headless.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef BREAKOUT_HEADLESS
+// Sem X11: o display vem da plataforma surfaceless do Mesa
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+bool HeadlessContext::create(int w, int h) {
+    width = w;
+    height = h;
+
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (dpy == EGL_NO_DISPLAY) dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, &major, &minor)) {
+        std::cerr << "Headless: no EGL display available" << std::endl;
+        return false;
+    }
+    display = dpy;
+
+    const char* extensions = eglQueryString(dpy, EGL_EXTENSIONS);
+    if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context")) {
+        std::cerr << "Headless: EGL_KHR_surfaceless_context not supported" << std::endl;
+        destroy();
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "Headless: desktop OpenGL not supported by EGL" << std::endl;
+        destroy();
+        return false;
+    }
+
+    // A plataforma surfaceless pode nao expor configs; sem superficie nao e preciso nenhuma
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    if (!std::strstr(extensions, "EGL_KHR_no_config_context")) {
+        const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLint count = 0;
+        if (!eglChooseConfig(dpy, configAttribs, &config, 1, &count) || count == 0) {
+            std::cerr << "Headless: no EGL config with OpenGL support" << std::endl;
+            destroy();
+            return false;
+        }
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttribs);
+    if (ctx == EGL_NO_CONTEXT) {
+        std::cerr << "Headless: failed to create OpenGL 3.3 core context (EGL error 0x"
+                  << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        destroy();
+        return false;
+    }
+    context = ctx;
+    if (!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) {
+        std::cerr << "Headless: eglMakeCurrent failed" << std::endl;
+        destroy();
+        return false;
+    }
+    std::cout << "Headless: EGL " << major << "." << minor << ", " << width << "x" << height << std::endl;
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (!display) return;
+    if (context) {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (colorRbo) glDeleteRenderbuffers(1, &colorRbo);
+        if (depthRbo) glDeleteRenderbuffers(1, &depthRbo);
+        fbo = colorRbo = depthRbo = 0;
+        eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+        context = nullptr;
+    }
+    eglTerminate((EGLDisplay)display);
+    display = nullptr;
+}
+
+bool HeadlessContext::makeCurrent(bool current) {
+    if (!display || !context) return false;
+    return eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, current ? (EGLContext)context : EGL_NO_CONTEXT) == EGL_TRUE;
+}
+
+#else
+
+bool HeadlessContext::create(int, int) {
+    std::cerr << "Headless: built without BREAKOUT_HEADLESS (EGL) support" << std::endl;
+    return false;
+}
+
+void HeadlessContext::destroy() {}
+
+bool HeadlessContext::makeCurrent(bool) {
+    return false;
+}
+
+#endif
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRbo);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Headless: offscreen framebuffer incomplete" << std::endl;
+        return false;
+    }
+    // Fica ligado durante todo o jogo: o renderer continua a desenhar "no ecra" sem saber do FBO
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void HeadlessContext::present() {
+    glFinish();
+}
+
+bool HeadlessContext::parseResolution(const char* text, int& w, int& h) {
+    int pw = 0, ph = 0;
+    if (std::sscanf(text, "%dx%d", &pw, &ph) != 2 || pw <= 0 || ph <= 0) return false;
+    w = pw;
+    h = ph;
+    return true;
+}
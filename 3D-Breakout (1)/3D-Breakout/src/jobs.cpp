@@ -0,0 +1,189 @@
+#include "jobs.h"
+
+#include "trace.h"
+
+namespace {
+
+// Antes de adormecer um worker tenta mais algumas vezes: os parallelFor por frame
+// chegam em rajadas e acordar uma thread custa dezenas de microssegundos
+const int SPIN_ATTEMPTS = 64;
+
+const char* const WORKER_NAMES[] = {
+    "job 1", "job 2", "job 3", "job 4", "job 5", "job 6", "job 7", "job 8",
+    "job 9", "job 10", "job 11", "job 12", "job 13", "job 14", "job 15", "job 16"
+};
+
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local int tlsQueue = -1;
+thread_local uint32_t tlsRng = 0x9E3779B9u;
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+JobSystem& jobs() {
+    static JobSystem instance;
+    return instance;
+}
+
+unsigned JobSystem::defaultWorkers() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+JobSystem::JobSystem(unsigned workerThreads)
+    : owner(std::this_thread::get_id()), externalCount(0), sleeping(0), wakeSignals(0), quit(false) {
+    for (unsigned i = 0; i <= workerThreads; i++) {
+        Worker* worker = new Worker();
+        worker->rng = 0x9E3779B9u * (i + 1);
+        queues.push_back(worker);
+    }
+    for (unsigned i = 1; i <= workerThreads; i++) workers.emplace_back(&JobSystem::workerLoop, this, (int)i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+    for (Worker* worker : queues) delete worker;
+}
+
+int JobSystem::currentQueue() const {
+    if (tlsSystem == this) return tlsQueue;
+    return std::this_thread::get_id() == owner ? 0 : -1;
+}
+
+void JobSystem::run(Job& job, JobCounter& counter) {
+    job.counter = &counter;
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    submit(&job);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, Job& job, JobCounter& counter) {
+    job.counter = &counter;
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        // finish() decrementa com o mesmo lock: ou ve a continuacao ou ja chegou a zero
+        std::lock_guard<std::mutex> lock(dependency.lock);
+        if (dependency.pending.load(std::memory_order_acquire) > 0) {
+            dependency.continuations.push_back(&job);
+            return;
+        }
+    }
+    submit(&job);
+}
+
+void JobSystem::submit(Job* job) {
+    int self = currentQueue();
+    if (self < 0 || !queues[self]->deque.push(job)) {
+        std::lock_guard<std::mutex> lock(externalLock);
+        external.push_back(job);
+        externalCount.fetch_add(1, std::memory_order_release);
+    }
+    notify();
+}
+
+void JobSystem::notify() {
+    // Par do fetch_add de 'sleeping' em workerLoop: ou o worker ve o job ao verificar
+    // outra vez, ou aqui ve-se que ha alguem a dormir
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed) == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        wakeSignals++;
+    }
+    wake.notify_one();
+}
+
+Job* JobSystem::findJob(int self) {
+    if (self >= 0) {
+        if (Job* job = queues[self]->deque.pop()) return job;
+    }
+    if (externalCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(externalLock);
+        if (!external.empty()) {
+            Job* job = external.front();
+            external.pop_front();
+            externalCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    // Uma volta a todos os deques a partir de uma vitima aleatoria
+    size_t count = queues.size();
+    uint32_t& rng = self >= 0 ? queues[self]->rng : tlsRng;
+    size_t start = nextRandom(rng) % count;
+    for (size_t i = 0; i < count; i++) {
+        size_t victim = (start + i) % count;
+        if ((int)victim == self) continue;
+        if (Job* job = queues[victim]->deque.steal()) return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job) {
+    JobCounter& counter = *job->counter;
+    job->fn(job->data, job->begin, job->end);
+    finish(counter);
+}
+
+void JobSystem::finish(JobCounter& counter) {
+    std::vector<Job*> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.lock);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) ready.swap(counter.continuations);
+    }
+    for (Job* job : ready) submit(job);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    int self = currentQueue();
+    while (!counter.done()) {
+        if (Job* job = findJob(self)) execute(job);
+        else std::this_thread::yield();
+    }
+    // O ultimo finish() ainda pode estar dentro do lock do contador
+    std::lock_guard<std::mutex> lock(counter.lock);
+}
+
+void JobSystem::workerLoop(int index) {
+    tlsSystem = this;
+    tlsQueue = index;
+    Trace::setThreadName(WORKER_NAMES[(index - 1) % (sizeof(WORKER_NAMES) / sizeof(WORKER_NAMES[0]))]);
+
+    int idle = 0;
+    while (true) {
+        if (Job* job = findJob(index)) {
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_ATTEMPTS) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        if (Job* job = findJob(index)) {
+            sleeping.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> lock(sleepLock);
+            wake.wait(lock, [this] { return quit || wakeSignals > 0; });
+            if (quit) return;
+            wakeSignals--;
+        }
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
@@ -0,0 +1,146 @@
+#include "latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "frame_arena.h"
+#include "trace.h"
+
+namespace {
+
+// Margem para o jitter do sleep e da estimativa de trabalho
+const float DEADLINE_MARGIN_MS = 1.5f;
+// Amostras reservadas no init: uma por frame, cerca de 18 min a 60 fps sem realocar
+const size_t RESERVED_SAMPLES = 65536;
+
+template <typename Vector>
+float percentile(const Vector& sorted, float p) {
+    if (sorted.empty()) return 0.0f;
+    return sorted[std::min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5f))];
+}
+
+} // namespace
+
+LatencyTracker& latency() {
+    static LatencyTracker instance;
+    return instance;
+}
+
+LatencyTracker::LatencyTracker()
+    : lowLatency(false), slot(0), ready(false), pendingInputNs(0), lastSampleNs(0), frameInputNs(0), sampleNs(0),
+      lastPresentNs(0), workEstimateMs(0.0f), rng(0x1234567u) {
+    for (int i = 0; i < LATENCY_QUERY_FRAMES; i++) {
+        queries[i] = renderQueries[i] = 0;
+        queryInputNs[i] = querySampleNs[i] = 0;
+        queryIssued[i] = false;
+    }
+}
+
+void LatencyTracker::init() {
+    glGenQueries(LATENCY_QUERY_FRAMES, queries);
+    glGenQueries(LATENCY_QUERY_FRAMES, renderQueries);
+    samples.reserve(RESERVED_SAMPLES);
+    ready = true;
+}
+
+void LatencyTracker::shutdown() {
+    if (!ready) return;
+    glDeleteQueries(LATENCY_QUERY_FRAMES, queries);
+    glDeleteQueries(LATENCY_QUERY_FRAMES, renderQueries);
+    ready = false;
+}
+
+void LatencyTracker::onInput() {
+    if (!pendingInputNs) pendingInputNs = Trace::nowNs();
+}
+
+void LatencyTracker::injectSyntheticInput() {
+    // Um evento real chega em qualquer instante entre duas leituras; espera-se pela seguinte
+    uint64_t now = Trace::nowNs();
+    if (!lastSampleNs || pendingInputNs) return;
+    rng = rng * 1664525u + 1013904223u;
+    double u = (rng >> 8) / 16777216.0;
+    pendingInputNs = lastSampleNs + (uint64_t)(u * (double)(now - lastSampleNs));
+}
+
+void LatencyTracker::sampleInput(uint64_t& inputNs, uint64_t& sampledNs) {
+    sampledNs = Trace::nowNs();
+    inputNs = pendingInputNs;
+    pendingInputNs = 0;
+    lastSampleNs = sampledNs;
+}
+
+void LatencyTracker::onFrameInput(uint64_t inputNs, uint64_t sampledNs) {
+    frameInputNs = inputNs;
+    sampleNs = sampledNs;
+}
+
+void LatencyTracker::beforeSwap() {
+    // Sem a espera pelo vblank: e o custo real do frame, usado para o prazo da amostragem tardia
+    if (ready) glQueryCounter(renderQueries[slot], GL_TIMESTAMP);
+}
+
+void LatencyTracker::onPresent() {
+    lastPresentNs = Trace::nowNs();
+    if (!ready) return;
+    // Se a query deste slot nunca ficou pronta descarta-se, em vez de esperar por ela
+    glQueryCounter(queries[slot], GL_TIMESTAMP);
+    queryInputNs[slot] = frameInputNs;
+    querySampleNs[slot] = sampleNs;
+    queryIssued[slot] = true;
+    slot = (slot + 1) % LATENCY_QUERY_FRAMES;
+    frameInputNs = 0;
+}
+
+void LatencyTracker::collect(int64_t gpuToCpuNs) {
+    if (!ready) return;
+    for (int i = 0; i < LATENCY_QUERY_FRAMES; i++) {
+        if (!queryIssued[i]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 stamp = 0, renderStamp = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &stamp);
+        glGetQueryObjectui64v(renderQueries[i], GL_QUERY_RESULT, &renderStamp);
+        queryIssued[i] = false;
+
+        int64_t photonNs = (int64_t)stamp + gpuToCpuNs;
+        float workMs = (float)(((int64_t)renderStamp + gpuToCpuNs - (int64_t)querySampleNs[i]) / 1.0e6);
+        if (workMs > 0.0f) workEstimateMs = workEstimateMs > 0.0f ? workEstimateMs * 0.9f + workMs * 0.1f : workMs;
+        if (queryInputNs[i]) samples.push_back(std::max(0.0f, (float)((photonNs - (int64_t)queryInputNs[i]) / 1.0e6)));
+    }
+}
+
+void LatencyTracker::resetSamples() {
+    samples.clear();
+}
+
+void LatencyTracker::waitForInputDeadline(double refreshHz) {
+    if (!lowLatency || refreshHz <= 0.0 || !lastPresentNs) return;
+    // Depois do glFinish o swap acabou de passar; o proximo vblank e um periodo depois
+    double periodMs = 1000.0 / refreshHz;
+    double elapsedMs = (Trace::nowNs() - lastPresentNs) / 1.0e6;
+    double sleepMs = periodMs - elapsedMs - workEstimateMs - DEADLINE_MARGIN_MS;
+    if (sleepMs > 0.5) std::this_thread::sleep_for(std::chrono::microseconds((long long)(sleepMs * 1000.0)));
+}
+
+LatencyStats LatencyTracker::stats(size_t lastN) const {
+    size_t first = (lastN && samples.size() > lastN) ? samples.size() - lastN : 0;
+    // Copia ordenada na arena do frame: o overlay pede isto a cada frame
+    ArenaVector<float> sorted(samples.begin() + first, samples.end(), ArenaAllocator<float>(frameArena().current()));
+    std::sort(sorted.begin(), sorted.end());
+    LatencyStats result;
+    result.median = percentile(sorted, 0.5f);
+    result.p99 = percentile(sorted, 0.99f);
+    result.max = sorted.empty() ? 0.0f : sorted.back();
+    result.count = sorted.size();
+    return result;
+}
+
+void LatencyTracker::printReport() const {
+    LatencyStats s = stats();
+    if (!s.count) return;
+    std::cout << "Input latency" << (lowLatency ? " (low-latency mode)" : "") << ": " << s.count << " samples, median "
+              << s.median << " ms, p99 " << s.p99 << " ms, max " << s.max << " ms" << std::endl;
+}
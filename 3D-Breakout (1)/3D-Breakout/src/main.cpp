@@ -1,7 +1,24 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <thread>
 #include "game.h"
+#include "vfs.h"
+#include "profiler.h"
+#include "trace.h"
+#include "benchmark.h"
+#include "headless.h"
+#include "latency.h"
+#include "frame_pacer.h"
+#include "triple_buffer.h"
+#include "jobs.h"
+#include "frame_arena.h"
+#include "alloc_hook.h"
+#include "input_queue.h"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -10,91 +27,447 @@ const unsigned int SCR_WIDTH = 1920;
 const unsigned int SCR_HEIGHT = 1080;
 
 Game* breakout = nullptr;
+double traceSeconds = 10.0;     // janela exportada por F2 / --trace
+bool traceOnExit = false;
+Benchmark bench;
+bool headless = false;
+HeadlessContext offscreen;
+bool adaptiveSync = false;
+double refreshHz = 0.0;         // so usado pela amostragem tardia do modo de baixa latencia
+FramePacer pacer;
+bool threaded = false;
+bool sphereImpostors = true;
+bool bakedRoomLighting = true;
+unsigned benchBalls = 0;
+GLFWwindow* window = nullptr;
+
+// --threaded: os callbacks do GLFW correm na thread principal e o ImGui vive na de render.
+// Os eventos da UI passam por esta fila e sao entregues ao ImGuiIO no inicio de cada frame
+enum UiEventType { UI_MOUSE_POS, UI_MOUSE_BUTTON, UI_SCROLL, UI_KEY, UI_CHAR };
+struct UiEvent {
+    UiEventType type;
+    int code;       // botao, tecla GLFW ou caracter
+    int action;     // GLFW_PRESS / GLFW_RELEASE
+    int scancode;
+    int mods;
+    float x, y;     // posicao do rato ou scroll
+};
+SpscQueue<UiEvent, 1024> uiEvents;
+
+// Traducao de teclas do backend GLFW do ImGui (definida em imgui_impl_glfw.cpp)
+ImGuiKey ImGui_ImplGlfw_KeyToImGuiKey(int keycode, int scancode);
+
+// Relogios do frame: o dt do render (ImGui, benchmark) e o relogio virtual da simulacao no benchmark
+float deltaTime = 0.0f, lastFrame = 0.0f;
+double benchStart = 0.0;
+uint64_t benchClockNs = 0;
+
+// Alocacoes do heap por frame: as da thread de render contam-se entre inicios de frame,
+// as da simulacao (so com --threaded) chegam por aqui
+std::atomic<uint64_t> simHeapAllocs(0);
+uint64_t renderAllocMark = 0;
+
+// --alloc-audit: input, update e render (com os scopes aninhados) sem alocacoes em GAME_ACTIVE
+bool allocAudit = false;
+uint64_t activeSinceNs = 0;
+const ProfileScopeId AUDITED_SCOPES[] = { PROFILE_INPUT, PROFILE_UPDATE, PROFILE_COLLISION, PROFILE_SCENE_RENDER, PROFILE_IMGUI_BUILD };
+const uint64_t AUDIT_GRACE_NS = 1000000000ull;    // primeiro segundo de jogo: caches e buffers ainda a crescer
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void mouse_button_callback(GLFWwindow*, int button, int action, int mods);
+void window_refresh_callback(GLFWwindow* window);
+void scroll_callback(GLFWwindow*, double xoffset, double yoffset);
+void char_callback(GLFWwindow*, unsigned int codepoint);
+void drainUiEvents();
+void countImGuiDraws(const ImDrawData* drawData);
+void auditFrame(const RenderSnapshot& frame);
+double currentTime();
+void simulateFrame(RenderSnapshot& frame, unsigned frameIndex);
+bool beginRenderFrame();
+void renderFrame(const RenderSnapshot& frame);
+void renderThreadMain(TripleBuffer<RenderSnapshot>* snapshots);
 
-int main() {
-    if (!glfwInit()) return -1;
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "3D Breakout", NULL, NULL);
-    if (!window) { glfwTerminate(); return -1; }
-    
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetKeyCallback(window, key_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        // --trace <segundos>: no fim grava os ultimos N segundos em breakout_trace.json
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) { traceSeconds = std::atof(argv[++i]); traceOnExit = true; }
+        // --bench <frames|segundos>s [--bench-out ficheiro.json]
+        else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) bench.parse(argv[++i]);
+        else if (std::strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) bench.reportPath = argv[++i];
+        // --low-latency: glFinish depois do swap e input lido o mais tarde possivel antes do vblank
+        else if (std::strcmp(argv[i], "--low-latency") == 0) latency().lowLatency = true;
+        // --adaptive-sync: vsync que deixa passar frames atrasados (swap_control_tear), se existir
+        else if (std::strcmp(argv[i], "--adaptive-sync") == 0) adaptiveSync = true;
+        // --frame-cap <fps>: limite de fps durante o jogo, alem do vsync
+        else if (std::strcmp(argv[i], "--frame-cap") == 0 && i + 1 < argc) pacer.frameCap = std::atoi(argv[++i]);
+        // --no-idle-throttle: desenha sempre, mesmo nos menus
+        else if (std::strcmp(argv[i], "--no-idle-throttle") == 0) pacer.idleThrottle = false;
+        // --threaded: simulacao na thread principal, GL numa thread de render (um frame em pipeline)
+        else if (std::strcmp(argv[i], "--threaded") == 0) threaded = true;
+        // --spheres mesh|impostor: bolas como malha (um draw cada) ou quads com ray casting (um draw instanciado)
+        else if (std::strcmp(argv[i], "--spheres") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "mesh") == 0) sphereImpostors = false;
+            else if (std::strcmp(mode, "impostor") == 0) sphereImpostors = true;
+            else { std::cerr << "Invalid --spheres mode: " << mode << std::endl; return -1; }
+        }
+        // --room-lighting baked|phong: sala com a luz cozinhada nos vertices (shader sem luz) ou Phong por fragmento
+        else if (std::strcmp(argv[i], "--room-lighting") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "baked") == 0) bakedRoomLighting = true;
+            else if (std::strcmp(mode, "phong") == 0) bakedRoomLighting = false;
+            else { std::cerr << "Invalid --room-lighting mode: " << mode << std::endl; return -1; }
+        }
+        // --bench-balls <n>: n bolas extra, so desenhadas, para medir o caminho das esferas (p.ex. 10000)
+        else if (std::strcmp(argv[i], "--bench-balls") == 0 && i + 1 < argc) benchBalls = (unsigned)std::atoi(argv[++i]);
+        // --alloc-audit: falha (codigo 1) se input, update ou render alocarem depois do primeiro segundo de jogo
+        else if (std::strcmp(argv[i], "--alloc-audit") == 0) allocAudit = true;
+        // --headless <LxA>: sem janela, desenha num FBO via EGL (CI sem display/GPU)
+        else if (std::strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+            int w, h;
+            if (!HeadlessContext::parseResolution(argv[++i], w, h)) { std::cerr << "Invalid --headless resolution: " << argv[i] << std::endl; return -1; }
+            offscreen.width = w;
+            offscreen.height = h;
+            headless = true;
+        }
+    }
+    Trace::setThreadName("main");
+    // Sem janela nao ha como fechar o jogo: o modo headless corre sempre o benchmark
+    if (headless && !bench.active) bench.parse("600");
+    // O pipeline acrescenta um frame de latencia de proposito; a amostragem tardia nao faz sentido
+    if (threaded && latency().lowLatency) { std::cout << "--low-latency is ignored with --threaded" << std::endl; latency().lowLatency = false; }
+    bench.threaded = threaded;
+    bench.sphereMode = sphereImpostors ? "impostor" : "mesh";
+    bench.sphereCount = 1 + benchBalls;
+    bench.roomLighting = bakedRoomLighting ? "baked" : "phong";
+
+    unsigned int width = headless ? offscreen.width : SCR_WIDTH;
+    unsigned int height = headless ? offscreen.height : SCR_HEIGHT;
+
+    if (headless) {
+        if (!offscreen.create(width, height)) return -1;
+    } else {
+        if (!glfwInit()) return -1;
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(width, height, "3D Breakout", NULL, NULL);
+        if (!window) { glfwTerminate(); return -1; }
+
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetKeyCallback(window, key_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetMouseButtonCallback(window, mouse_button_callback);
+        glfwSetWindowRefreshCallback(window, window_refresh_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetCharCallback(window, char_callback);
+
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
 
     glewExperimental = GL_TRUE;
-    if (glewInit() != GLEW_OK) return -1;
-    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+    GLenum glewStatus = glewInit();
+    // Um GLEW compilado para GLX queixa-se da falta de display X, mas as funcoes GL carregam na mesma
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY) glewStatus = GLEW_OK;
+#endif
+    if (glewStatus != GLEW_OK) return -1;
+    if (headless) {
+        if (!offscreen.createFramebuffer()) return -1;
+    } else {
+        // No benchmark mede-se o custo real do frame, sem esperar pelo vsync
+        if (bench.active) glfwSwapInterval(0);
+        else if (adaptiveSync) {
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear")) glfwSwapInterval(-1);
+            else { std::cout << "Adaptive sync not supported, using vsync" << std::endl; glfwSwapInterval(1); }
+        }
+        else glfwSwapInterval(1);
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        if (!bench.active && mode) refreshHz = mode->refreshRate;
+        glViewport(0, 0, width, height);
+    }
     glEnable(GL_DEPTH_TEST);
     
     IMGUI_CHECKVERSION();
+    // O ImGui passa pelo operator new para as suas alocacoes tambem serem contadas
+    ImGui::SetAllocatorFunctions([](size_t size, void*) { return ::operator new(size); }, [](void* p, void*) { ::operator delete(p); });
     ImGui::CreateContext();
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    // Os callbacks do backend GLFW escreveriam no ImGuiIO a partir da thread principal: com
+    // --threaded os nossos mandam os eventos para uiEvents e a thread de render entrega-os
+    if (!headless && !threaded) ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 330");
     ImGui::StyleColorsDark();
 
-    breakout = new Game(SCR_WIDTH, SCR_HEIGHT);
+    // Com assets.pak presente todos os assets vem do arquivo mapeado; senao dos ficheiros soltos
+    Vfs::mount("assets.pak");
+
+    // Workers criados aqui: a thread principal fica dona do deque 0 (carregamento e simulacao)
+    jobs();
+    breakout = new Game(width, height);
     breakout->init();
+    breakout->autopilot = bench.active;
+    breakout->sphereImpostors = sphereImpostors;
+    breakout->bakedRoomLighting = bakedRoomLighting;
+    breakout->benchBalls = benchBalls;
+    profiler().init();
+    latency().init();
     
-    float deltaTime = 0.0f, lastFrame = 0.0f;
-    
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-        
-        glfwPollEvents();
-        
-        breakout->processInput(deltaTime);
-        breakout->update(deltaTime);
-        
-        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-        
-        breakout->render();
-        
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        
-        glfwSwapBuffers(window);
+    benchStart = currentTime();
+    benchClockNs = Trace::nowNs();    // no benchmark a simulacao corre num relogio virtual
+    unsigned simFrame = 0;
+
+    if (threaded) {
+        // O contexto passa para a thread de render; a principal fica com o GLFW e a simulacao
+        TripleBuffer<RenderSnapshot> snapshots;
+        if (headless) offscreen.makeCurrent(false);
+        else glfwMakeContextCurrent(nullptr);
+        std::thread renderThread(renderThreadMain, &snapshots);
+
+        while (headless || !glfwWindowShouldClose(window)) {
+            bool animating = bench.active || headless || breakout->isAnimating();
+            if (!pacer.waitForWork(animating)) continue;
+            // No maximo um frame a frente do render: a simulacao N+1 corre durante o render N
+            if (!snapshots.waitConsumed()) break;
+            simulateFrame(snapshots.writeSlot(), simFrame++);
+            snapshots.publish();
+            pacer.limitFrameRate(animating);
+        }
+        snapshots.close();
+        renderThread.join();
+        if (headless) offscreen.makeCurrent(true);
+        else glfwMakeContextCurrent(window);
+    } else {
+        RenderSnapshot frame;
+        while (headless || !glfwWindowShouldClose(window)) {
+            // O benchmark e o modo headless desenham sempre: o custo medido e o do frame
+            bool animating = bench.active || headless || breakout->isAnimating();
+            if (!pacer.waitForWork(animating)) continue;
+            latency().waitForInputDeadline(refreshHz);
+            if (!beginRenderFrame()) break;
+            simulateFrame(frame, simFrame++);
+            renderFrame(frame);
+            pacer.limitFrameRate(animating);
+        }
     }
-    
+
+    if (traceOnExit) Trace::dump("breakout_trace.json", traceSeconds);
+    latency().printReport();
+    pacer.printReport();
+    bench.setLatency(latency().stats());
+    if (bench.active) bench.writeReport(reinterpret_cast<const char*>(glGetString(GL_RENDERER)), currentTime() - benchStart);
+    bool auditPassed = !allocAudit || profiler().printAllocAudit();
+
     delete breakout;
+    profiler().shutdown();
+    latency().shutdown();
+    Vfs::unmount();
 
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (!headless && !threaded) ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
-    glfwTerminate();
-    return 0;
+    if (headless) offscreen.destroy();
+    else glfwTerminate();
+    return auditPassed ? 0 : 1;
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    pacer.requestRedraw();
+    // O viewport vem no snapshot: com --threaded esta thread nao tem o contexto
     if (breakout) breakout->updateResolution(width, height);
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
-    if (key >= 0 && key < 1024 && breakout) {
-        if (action == GLFW_PRESS) breakout->keys[key] = true;
-        else if (action == GLFW_RELEASE) breakout->keys[key] = false;
-    }
+    if (key == GLFW_KEY_F1 && action == GLFW_PRESS)
+        profiler().visible = !profiler().visible;
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS)
+        Trace::dump("breakout_trace_" + std::to_string((long long)currentTime()) + ".json", traceSeconds);
+    latency().onInput();
+    pacer.requestRedraw();
+    if (breakout && (action == GLFW_PRESS || action == GLFW_RELEASE))
+        breakout->input.push(InputEvent{ Trace::nowNs(), key, action });
+    if (threaded) uiEvents.push(UiEvent{ UI_KEY, key, action, scancode, mode, 0.0f, 0.0f });
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    latency().onInput();
+    pacer.requestRedraw();
     if (breakout) breakout->processMouseMovement((float)xpos, (float)ypos);
-}
\ No newline at end of file
+    if (threaded) uiEvents.push(UiEvent{ UI_MOUSE_POS, 0, 0, 0, 0, (float)xpos, (float)ypos });
+}
+
+void mouse_button_callback(GLFWwindow*, int button, int action, int mods) {
+    pacer.requestRedraw();
+    if (threaded) uiEvents.push(UiEvent{ UI_MOUSE_BUTTON, button, action, 0, mods, 0.0f, 0.0f });
+}
+
+void scroll_callback(GLFWwindow*, double xoffset, double yoffset) {
+    pacer.requestRedraw();
+    if (threaded) uiEvents.push(UiEvent{ UI_SCROLL, 0, 0, 0, 0, (float)xoffset, (float)yoffset });
+}
+
+void char_callback(GLFWwindow*, unsigned int codepoint) {
+    pacer.requestRedraw();
+    if (threaded) uiEvents.push(UiEvent{ UI_CHAR, (int)codepoint, 0, 0, 0, 0.0f, 0.0f });
+}
+
+// Janela exposta ou redimensionada com o loop parado
+void window_refresh_callback(GLFWwindow*) {
+    pacer.requestRedraw();
+}
+
+// Camara do benchmark, input e passos fixos; acaba com a copia do estado para o render
+void simulateFrame(RenderSnapshot& frame, unsigned frameIndex) {
+    // Sem thread de render a arena e o contador sao os do frame de render
+    uint64_t allocMark = AllocHook::thisThread().allocations;
+    if (threaded) frameArena().beginFrame();
+    if (bench.active) {
+        // Simulacao e camara deterministas: passo fixo e percurso indexado pelo frame
+        float yaw, pitch;
+        bench.cameraAt(frameIndex, yaw, pitch);
+        breakout->setCameraAngles(yaw, pitch);
+    }
+    {
+        PROFILE_SCOPE(PROFILE_INPUT);
+        // O bot nao gera eventos: simula-se um por frame para medir a latencia na mesma
+        if (bench.active) latency().injectSyntheticInput();
+        if (!headless) glfwPollEvents();
+    }
+    {
+        PROFILE_SCOPE(PROFILE_UPDATE);
+        if (bench.active) benchClockNs += (uint64_t)(Benchmark::FIXED_DT * 1e9);
+        breakout->advance(bench.active ? benchClockNs : Trace::nowNs());
+        latency().sampleInput(frame.inputNs, frame.sampleNs);
+        breakout->snapshot(frame);
+    }
+    if (threaded) simHeapAllocs.fetch_add(AllocHook::thisThread().allocations - allocMark, std::memory_order_relaxed);
+}
+
+// Inicio do frame do lado do render; false quando o benchmark terminou
+bool beginRenderFrame() {
+    frameArena().beginFrame();
+    uint64_t allocations = AllocHook::thisThread().allocations;
+    uint64_t heapAllocs = allocations - renderAllocMark + simHeapAllocs.exchange(0, std::memory_order_relaxed);
+    renderAllocMark = allocations;
+    profiler().beginFrame();
+    latency().collect(profiler().gpuClockOffsetNs());
+    float currentFrame = static_cast<float>(currentTime());
+    deltaTime = currentFrame - lastFrame;
+    lastFrame = currentFrame;
+
+    if (bench.active) {
+        if (bench.frames() == 0) benchStart = currentTime();
+        if (bench.frames() == (unsigned)Benchmark::WARMUP_FRAMES) latency().resetSamples();
+        bench.recordFrame(deltaTime * 1000.0f, profiler().lastDrawCalls, profiler().lastTriangles, heapAllocs);
+        if (bench.finished(currentTime() - benchStart)) return false;
+    }
+    return true;
+}
+
+void renderFrame(const RenderSnapshot& frame) {
+    latency().onFrameInput(frame.inputNs, frame.sampleNs);
+    glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    ImGui_ImplOpenGL3_NewFrame();
+    if (headless || threaded) {
+        // Sem backend de plataforma o ImGui precisa do tamanho e do dt a mao
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2((float)frame.width, (float)frame.height);
+        io.DeltaTime = deltaTime > 0.0f ? deltaTime : Benchmark::FIXED_DT;
+        if (threaded && !headless) drainUiEvents();
+    } else {
+        ImGui_ImplGlfw_NewFrame();
+    }
+    ImGui::NewFrame();
+
+    breakout->render(frame);
+
+    {
+        PROFILE_SCOPE(PROFILE_IMGUI_RENDER);
+        PROFILE_GPU(GPU_IMGUI);
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        countImGuiDraws(ImGui::GetDrawData());
+    }
+    {
+        PROFILE_SCOPE(PROFILE_SWAP);
+        latency().beforeSwap();
+        if (headless) offscreen.present();
+        else glfwSwapBuffers(window);
+        // Sem frames em fila: o proximo frame so comeca depois de este estar na GPU
+        if (latency().lowLatency) glFinish();
+        latency().onPresent();
+    }
+    profiler().endFrame();
+    if (allocAudit) auditFrame(frame);
+}
+
+// Thread de render (--threaded): o mesmo que os callbacks do backend GLFW fariam
+void drainUiEvents() {
+    ImGuiIO& io = ImGui::GetIO();
+    while (const UiEvent* e = uiEvents.peek()) {
+        switch (e->type) {
+        case UI_MOUSE_POS: io.AddMousePosEvent(e->x, e->y); break;
+        case UI_MOUSE_BUTTON:
+            if (e->code >= 0 && e->code < ImGuiMouseButton_COUNT) io.AddMouseButtonEvent(e->code, e->action == GLFW_PRESS);
+            break;
+        case UI_SCROLL: io.AddMouseWheelEvent(e->x, e->y); break;
+        case UI_KEY:
+            if (e->action == GLFW_PRESS || e->action == GLFW_RELEASE) {
+                io.AddKeyEvent(ImGuiMod_Ctrl, (e->mods & GLFW_MOD_CONTROL) != 0);
+                io.AddKeyEvent(ImGuiMod_Shift, (e->mods & GLFW_MOD_SHIFT) != 0);
+                io.AddKeyEvent(ImGuiMod_Alt, (e->mods & GLFW_MOD_ALT) != 0);
+                io.AddKeyEvent(ImGuiMod_Super, (e->mods & GLFW_MOD_SUPER) != 0);
+                io.AddKeyEvent(ImGui_ImplGlfw_KeyToImGuiKey(e->code, e->scancode), e->action == GLFW_PRESS);
+            }
+            break;
+        case UI_CHAR: io.AddInputCharacter((unsigned int)e->code); break;
+        }
+        uiEvents.pop();
+    }
+}
+
+void auditFrame(const RenderSnapshot& frame) {
+    if (frame.state != GAME_ACTIVE) { activeSinceNs = 0; return; }
+    uint64_t now = Trace::nowNs();
+    if (!activeSinceNs) activeSinceNs = now;
+    if (now - activeSinceNs > AUDIT_GRACE_NS) profiler().auditAllocations(AUDITED_SCOPES, sizeof(AUDITED_SCOPES) / sizeof(AUDITED_SCOPES[0]));
+}
+
+// --threaded: dona do contexto GL; desenha sempre o snapshot mais recente
+void renderThreadMain(TripleBuffer<RenderSnapshot>* snapshots) {
+    Trace::setThreadName("render");
+    if (headless) offscreen.makeCurrent(true);
+    else glfwMakeContextCurrent(window);
+
+    while (snapshots->waitFresh()) {
+        snapshots->acquire();
+        if (!beginRenderFrame()) break;
+        renderFrame(snapshots->readSlot());
+    }
+    // Se foi o benchmark a acabar, acorda a simulacao
+    snapshots->close();
+    if (headless) offscreen.makeCurrent(false);
+    else glfwMakeContextCurrent(nullptr);
+}
+
+void countImGuiDraws(const ImDrawData* drawData) {
+    for (int i = 0; i < drawData->CmdListsCount; i++) {
+        const ImDrawList* list = drawData->CmdLists[i];
+        for (int c = 0; c < list->CmdBuffer.Size; c++) {
+            if (!list->CmdBuffer[c].UserCallback) profiler().countDraw(list->CmdBuffer[c].ElemCount);
+        }
+    }
+}
+
+// Relogio independente do GLFW, que nao e inicializado no modo headless
+double currentTime() {
+    static const uint64_t start = Trace::nowNs();
+    return (Trace::nowNs() - start) * 1e-9;
+}
@@ -0,0 +1,144 @@
+#include "particles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+namespace {
+
+const size_t LANES = 4;
+
+size_t roundUp(size_t value) {
+    return (value + LANES - 1) & ~(LANES - 1);
+}
+
+} // namespace
+
+ParticlePool::ParticlePool(size_t capacity)
+    : block(nullptr), freeSlots(nullptr), freeCount(0), slots(roundUp(std::max<size_t>(capacity, LANES))), highWater(0), aliveCount(0),
+      rng(0x2545F491u) {
+    // Um so bloco para todos os campos; cada campo comeca alinhado porque slots e multiplo de 4
+    block = static_cast<float*>(::operator new(slots * FIELD_COUNT * sizeof(float), std::align_val_t(16)));
+    std::memset(block, 0, slots * FIELD_COUNT * sizeof(float));
+    for (int f = 0; f < FIELD_COUNT; f++) fields[f] = block + f * slots;
+    freeSlots = new uint32_t[slots];
+}
+
+ParticlePool::~ParticlePool() {
+    ::operator delete(block, std::align_val_t(16));
+    delete[] freeSlots;
+}
+
+float ParticlePool::random() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+unsigned ParticlePool::emit(const ParticleBurst& burst) {
+    unsigned emitted = 0;
+    for (; emitted < burst.count; emitted++) {
+        size_t i;
+        if (freeCount) i = freeSlots[--freeCount];
+        else if (highWater < slots) i = highWater++;
+        else break;
+
+        // Direccao aleatoria no plano do tabuleiro, com um pouco de Z e tendencia para cima
+        float angle = random() * 6.2831853f;
+        float speed = burst.speed * (0.3f + 0.7f * random());
+        float life = burst.life * (0.5f + random());
+        float shade = 0.8f + 0.4f * random();
+        fields[PX][i] = burst.center.x + (random() - 0.5f) * burst.extent.x;
+        fields[PY][i] = burst.center.y + (random() - 0.5f) * burst.extent.y;
+        fields[PZ][i] = burst.center.z + (random() - 0.5f) * burst.extent.z;
+        fields[VX][i] = std::cos(angle) * speed;
+        fields[VY][i] = std::sin(angle) * speed + 0.3f * burst.speed;
+        fields[VZ][i] = (random() - 0.5f) * speed;
+        fields[LIFE][i] = life;
+        fields[FADE][i] = 1.0f / life;
+        fields[R][i] = std::min(1.0f, burst.color.x * shade);
+        fields[G][i] = std::min(1.0f, burst.color.y * shade);
+        fields[B][i] = std::min(1.0f, burst.color.z * shade);
+        fields[SIZE][i] = burst.size * (0.5f + random());
+        aliveCount++;
+    }
+    return emitted;
+}
+
+void ParticlePool::update(float dt, float gravity, float drag) {
+    if (!aliveCount) return;
+    float damping = std::max(0.0f, 1.0f - drag * dt);
+    float* px = fields[PX]; float* py = fields[PY]; float* pz = fields[PZ];
+    float* vx = fields[VX]; float* vy = fields[VY]; float* vz = fields[VZ];
+    float* life = fields[LIFE];
+    size_t end = roundUp(highWater);
+
+#ifdef PARTICLES_SSE2
+    __m128 zero = _mm_setzero_ps();
+    __m128 step = _mm_set1_ps(dt);
+    __m128 fall = _mm_set1_ps(-gravity * dt);
+    __m128 damp = _mm_set1_ps(damping);
+    for (size_t i = 0; i < end; i += LANES) {
+        __m128 oldLife = _mm_load_ps(life + i);
+        __m128 wasAlive = _mm_cmpgt_ps(oldLife, zero);
+        if (!_mm_movemask_ps(wasAlive)) continue;    // grupo todo livre
+
+        // Os lugares livres do grupo tambem andam: a vida fica presa em 0 e o resto e reescrito no emit
+        __m128 x = _mm_mul_ps(_mm_load_ps(vx + i), damp);
+        __m128 y = _mm_mul_ps(_mm_add_ps(_mm_load_ps(vy + i), fall), damp);
+        __m128 z = _mm_mul_ps(_mm_load_ps(vz + i), damp);
+        _mm_store_ps(vx + i, x);
+        _mm_store_ps(vy + i, y);
+        _mm_store_ps(vz + i, z);
+        _mm_store_ps(px + i, _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(x, step)));
+        _mm_store_ps(py + i, _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(y, step)));
+        _mm_store_ps(pz + i, _mm_add_ps(_mm_load_ps(pz + i), _mm_mul_ps(z, step)));
+
+        __m128 newLife = _mm_max_ps(_mm_sub_ps(oldLife, step), zero);
+        _mm_store_ps(life + i, newLife);
+        int died = _mm_movemask_ps(_mm_and_ps(wasAlive, _mm_cmple_ps(newLife, zero)));
+        for (size_t lane = 0; died; lane++, died >>= 1) {
+            if (died & 1) { freeSlots[freeCount++] = (uint32_t)(i + lane); aliveCount--; }
+        }
+    }
+#else
+    for (size_t i = 0; i < end; i++) {
+        if (life[i] <= 0.0f) continue;
+        vx[i] *= damping;
+        vy[i] = (vy[i] - gravity * dt) * damping;
+        vz[i] *= damping;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        pz[i] += vz[i] * dt;
+        life[i] = std::max(life[i] - dt, 0.0f);
+        if (life[i] <= 0.0f) { freeSlots[freeCount++] = (uint32_t)i; aliveCount--; }
+    }
+#endif
+
+    // Todas mortas: volta-se ao inicio e o proximo update so percorre o que for usado
+    if (!aliveCount) { highWater = 0; freeCount = 0; }
+}
+
+void ParticlePool::clear() {
+    std::fill(fields[LIFE], fields[LIFE] + roundUp(highWater), 0.0f);
+    highWater = 0;
+    freeCount = 0;
+    aliveCount = 0;
+}
+
+void ParticlePool::pack(std::vector<ParticleInstance>& out) const {
+    out.clear();
+    const float* life = fields[LIFE];
+    for (size_t i = 0; i < highWater; i++) {
+        if (life[i] <= 0.0f) continue;
+        out.push_back(ParticleInstance{ glm::vec4(fields[PX][i], fields[PY][i], fields[PZ][i], fields[SIZE][i]),
+                                        glm::vec4(fields[R][i], fields[G][i], fields[B][i], life[i] * fields[FADE][i]) });
+    }
+}
@@ -0,0 +1,207 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include "alloc_hook.h"
+#include "imgui.h"
+#include "trace.h"
+#include "latency.h"
+
+namespace {
+
+const char* const SCOPE_NAMES[PROFILE_SCOPE_COUNT] = {
+    "Frame", "Input", "Update", "Collision", "Scene render", "ImGui build", "ImGui render", "Swap"
+};
+
+const char* const GPU_PASS_NAMES[GPU_PASS_COUNT] = { "GPU scene", "GPU ImGui" };
+
+// Inicio de cada scope aberto, por thread (tempo e contador de alocacoes da thread)
+thread_local uint64_t cpuStart[PROFILE_SCOPE_COUNT];
+thread_local uint64_t allocStart[PROFILE_SCOPE_COUNT];
+
+} // namespace
+
+void RollingSamples::add(float ms) {
+    samples[next] = ms;
+    next = (next + 1) % PROFILE_WINDOW;
+    if (count < PROFILE_WINDOW) count++;
+}
+
+ProfileStats RollingSamples::stats() const {
+    ProfileStats result = { 0.0f, 0.0f, 0.0f };
+    if (count == 0) return result;
+
+    std::array<float, PROFILE_WINDOW> sorted;
+    std::copy(samples.begin(), samples.begin() + count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + count);
+
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) sum += sorted[i];
+    result.min = sorted[0];
+    result.avg = sum / count;
+    result.p99 = sorted[std::min(count - 1, (int)(count * 0.99f))];
+    return result;
+}
+
+Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler()
+    : visible(false), drawCalls(0), triangles(0), lastDrawCalls(0), lastTriangles(0), culling(), lastCulling(), auditedFrames(0), frameIndex(0), gpuReady(false), gpuToCpuNs(0) {
+    for (auto& accum : cpuAccumNs) accum.store(0, std::memory_order_relaxed);
+    for (auto& accum : allocAccum) accum.store(0, std::memory_order_relaxed);
+    lastAllocs.fill(0);
+    auditAllocs.fill(0);
+    auditFrames.fill(0);
+    for (int f = 0; f < GPU_QUERY_FRAMES; f++) {
+        for (int p = 0; p < GPU_PASS_COUNT; p++) { queries[f][p] = 0; stamps[f][p] = 0; queryIssued[f][p] = false; }
+    }
+}
+
+void Profiler::init() {
+    for (int f = 0; f < GPU_QUERY_FRAMES; f++) {
+        glGenQueries(GPU_PASS_COUNT, queries[f]);
+        glGenQueries(GPU_PASS_COUNT, stamps[f]);
+    }
+    gpuReady = true;
+}
+
+void Profiler::shutdown() {
+    if (!gpuReady) return;
+    for (int f = 0; f < GPU_QUERY_FRAMES; f++) {
+        glDeleteQueries(GPU_PASS_COUNT, queries[f]);
+        glDeleteQueries(GPU_PASS_COUNT, stamps[f]);
+    }
+    gpuReady = false;
+}
+
+void Profiler::beginFrame() {
+    drawCalls = 0;
+    triangles = 0;
+    culling = CullCounts();
+    beginCpu(PROFILE_FRAME);
+
+    // Resultados do frame anterior: so se leem se ja estiverem disponiveis
+    if (!gpuReady) return;
+
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpuToCpuNs = (int64_t)Trace::nowNs() - (int64_t)gpuNow;
+
+    unsigned slot = (frameIndex + 1) % GPU_QUERY_FRAMES;
+    for (int p = 0; p < GPU_PASS_COUNT; p++) {
+        if (!queryIssued[slot][p]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 elapsed = 0, stamp = 0;
+        glGetQueryObjectui64v(queries[slot][p], GL_QUERY_RESULT, &elapsed);
+        glGetQueryObjectui64v(stamps[slot][p], GL_QUERY_RESULT, &stamp);
+        gpuSamples[p].add((float)(elapsed / 1.0e6));
+        uint64_t start = (uint64_t)((int64_t)stamp + gpuToCpuNs);
+        Trace::recordGpu(GPU_PASS_NAMES[p], start, start + elapsed);
+        queryIssued[slot][p] = false;
+    }
+}
+
+void Profiler::endFrame() {
+    endCpu(PROFILE_FRAME);
+    for (int i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+        cpuSamples[i].add(cpuAccumNs[i].exchange(0, std::memory_order_relaxed) / 1.0e6f);
+        lastAllocs[i] = allocAccum[i].exchange(0, std::memory_order_relaxed);
+    }
+    lastDrawCalls = drawCalls;
+    lastTriangles = triangles;
+    lastCulling = culling;
+    frameIndex++;
+}
+
+void Profiler::beginCpu(ProfileScopeId id) {
+    cpuStart[id] = Trace::nowNs();
+    allocStart[id] = AllocHook::thisThread().allocations;
+}
+
+void Profiler::endCpu(ProfileScopeId id) {
+    uint64_t end = Trace::nowNs();
+    cpuAccumNs[id].fetch_add(end - cpuStart[id], std::memory_order_relaxed);
+    allocAccum[id].fetch_add(AllocHook::thisThread().allocations - allocStart[id], std::memory_order_relaxed);
+    Trace::record(SCOPE_NAMES[id], cpuStart[id], end);
+}
+
+void Profiler::beginGpu(GpuPassId pass) {
+    if (!gpuReady) return;
+    unsigned slot = frameIndex % GPU_QUERY_FRAMES;
+    // Se o resultado antigo nunca ficou pronto descarta-se, em vez de esperar por ele
+    glQueryCounter(stamps[slot][pass], GL_TIMESTAMP);
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot][pass]);
+}
+
+void Profiler::endGpu(GpuPassId pass) {
+    if (!gpuReady) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    queryIssued[frameIndex % GPU_QUERY_FRAMES][pass] = true;
+}
+
+void Profiler::renderOverlay() {
+    if (!visible) return;
+
+    ImGui::SetNextWindowPos(ImVec2(260, 20), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing);
+    bool allocs = AllocHook::enabled();
+    ImGui::Text("%-13s %7s %7s %7s%s", "ms", "min", "avg", "p99", allocs ? "  allocs" : "");
+    for (int i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+        ProfileStats s = cpuSamples[i].stats();
+        if (allocs) ImGui::Text("%-13s %7.3f %7.3f %7.3f %7llu", SCOPE_NAMES[i], s.min, s.avg, s.p99, (unsigned long long)lastAllocs[i]);
+        else ImGui::Text("%-13s %7.3f %7.3f %7.3f", SCOPE_NAMES[i], s.min, s.avg, s.p99);
+    }
+    ImGui::Separator();
+    for (int p = 0; p < GPU_PASS_COUNT; p++) {
+        ProfileStats s = gpuSamples[p].stats();
+        ImGui::Text("%-13s %7.3f %7.3f %7.3f", GPU_PASS_NAMES[p], s.min, s.avg, s.p99);
+    }
+    ImGui::Separator();
+    ImGui::Text("Draw calls %u, triangles %llu", lastDrawCalls, lastTriangles);
+    const CullCounts& c = lastCulling;
+    if (c.meshesDrawn + c.meshesCulled)
+        ImGui::Text("Meshes %u drawn, %u culled; clusters %u drawn, %u culled, %u backfacing", c.meshesDrawn, c.meshesCulled,
+                    c.clustersDrawn, c.clustersCulled, c.clustersBackfacing);
+    LatencyStats lat = latency().stats(PROFILE_WINDOW);
+    if (lat.count) ImGui::Text("Input->photon median %.2f ms, p99 %.2f ms%s", lat.median, lat.p99, latency().lowLatency ? " (low latency)" : "");
+    ImGui::TextDisabled("F1 toggles this overlay, F2 dumps a trace");
+    ImGui::End();
+}
+
+void Profiler::auditAllocations(const ProfileScopeId* scopes, int count) {
+    auditedFrames++;
+    for (int i = 0; i < count; i++) {
+        ProfileScopeId id = scopes[i];
+        if (!lastAllocs[id]) continue;
+        if (!auditFrames[id])
+            std::cerr << "Alloc audit: " << lastAllocs[id] << " heap allocations in scope '" << SCOPE_NAMES[id] << "' (frame " << frameIndex << ")" << std::endl;
+        auditAllocs[id] += lastAllocs[id];
+        auditFrames[id]++;
+    }
+}
+
+bool Profiler::printAllocAudit() const {
+    if (!AllocHook::enabled()) {
+        std::cout << "Alloc audit: built without the allocation hook (BREAKOUT_ALLOC_HOOK=OFF)" << std::endl;
+        return false;
+    }
+    if (!auditedFrames) {
+        std::cout << "Alloc audit: no frames audited (needs more than 1 s in game)" << std::endl;
+        return false;
+    }
+    bool clean = true;
+    for (int i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+        if (!auditFrames[i]) continue;
+        std::cout << "Alloc audit: FAIL '" << SCOPE_NAMES[i] << "' allocated " << auditAllocs[i] << " times in " << auditFrames[i]
+                  << " of " << auditedFrames << " frames" << std::endl;
+        clean = false;
+    }
+    if (clean) std::cout << "Alloc audit: OK, " << auditedFrames << " frames without heap allocations" << std::endl;
+    return clean;
+}
@@ -0,0 +1,54 @@
+#include "registry.h"
+
+#include <atomic>
+#include <cassert>
+
+size_t Registry::nextComponentId() {
+    static std::atomic<size_t> next(0);
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+Entity Registry::create() {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        assert(generations.size() < ENTITY_MAX_COUNT && "Registry: entity index space exhausted");
+        index = (uint32_t)generations.size();
+        generations.push_back(0);
+        // destroy() nunca realoca: ha sempre lugar para todos os indices na lista livre
+        if (freeIndices.capacity() < generations.capacity()) freeIndices.reserve(generations.capacity());
+    }
+    aliveCount++;
+    return (generations[index] << ENTITY_INDEX_BITS) | index;
+}
+
+void Registry::destroy(Entity e) {
+    if (!valid(e)) return;
+    for (auto& pool : pools) {
+        if (pool) pool->remove(e);
+    }
+    uint32_t index = entityIndex(e);
+    generations[index] = (generations[index] + 1) & 0xFFu;
+    freeIndices.push_back(index);
+    aliveCount--;
+}
+
+bool Registry::valid(Entity e) const {
+    uint32_t index = entityIndex(e);
+    return e != NULL_ENTITY && index < generations.size() && generations[index] == entityGeneration(e);
+}
+
+void Registry::clear() {
+    for (auto& pool : pools) {
+        if (pool) pool->clear();
+    }
+    // Todos os handles antigos ficam invalidos; os indices voltam a sair por ordem crescente
+    freeIndices.clear();
+    for (size_t i = generations.size(); i-- > 0;) {
+        generations[i] = (generations[i] + 1) & 0xFFu;
+        freeIndices.push_back((uint32_t)i);
+    }
+    aliveCount = 0;
+}
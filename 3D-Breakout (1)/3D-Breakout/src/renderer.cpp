@@ -1,11 +1,9 @@
 #include "renderer.h"
-#include <cmath>
+#include "geometry.h"
+#include "particles.h"
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-Renderer::Renderer() : cubeVAO(0), sphereVAO(0), cubeVBO(0), sphereVBO(0), sphereVertexCount(0) {}
+Renderer::Renderer() : cubeVAO(0), sphereVAO(0), sphereVertexCount(0), particleVAO(0), particleInstanceVBO(0), particleCapacity(0),
+      impostorVAO(0), impostorInstanceVBO(0), impostorCapacity(0), cubeVBO(0), sphereVBO(0), impostorQuadVBO(0) {}
 
 Renderer::~Renderer() {
     cleanup();
@@ -14,6 +12,8 @@ Renderer::~Renderer() {
 void Renderer::init() {
     createCube();
     createSphere(1.0f, 32, 16);
+    createParticles(ParticlePool::DEFAULT_CAPACITY);
+    createImpostors(64);
 }
 
 void Renderer::cleanup() {
@@ -21,6 +21,11 @@ void Renderer::cleanup() {
     if (cubeVBO) glDeleteBuffers(1, &cubeVBO);
     if (sphereVAO) glDeleteVertexArrays(1, &sphereVAO);
     if (sphereVBO) glDeleteBuffers(1, &sphereVBO);
+    if (particleVAO) glDeleteVertexArrays(1, &particleVAO);
+    if (particleInstanceVBO) glDeleteBuffers(1, &particleInstanceVBO);
+    if (impostorVAO) glDeleteVertexArrays(1, &impostorVAO);
+    if (impostorQuadVBO) glDeleteBuffers(1, &impostorQuadVBO);
+    if (impostorInstanceVBO) glDeleteBuffers(1, &impostorInstanceVBO);
 }
 
 void Renderer::createCube() {
@@ -84,56 +89,8 @@ void Renderer::createCube() {
 }
 
 void Renderer::createSphere(float radius, int sectors, int stacks) {
-    std::vector<float> vertices;
-    
-    for (int i = 0; i <= stacks; ++i) {
-        float stackAngle = M_PI / 2 - i * M_PI / stacks;
-        float xy = radius * cosf(stackAngle);
-        float z = radius * sinf(stackAngle);
-        
-        for (int j = 0; j <= sectors; ++j) {
-            float sectorAngle = j * 2 * M_PI / sectors;
-            float x = xy * cosf(sectorAngle);
-            float y = xy * sinf(sectorAngle);
-            
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-            
-            float nx = x / radius;
-            float ny = y / radius;
-            float nz = z / radius;
-            vertices.push_back(nx);
-            vertices.push_back(ny);
-            vertices.push_back(nz);
-        }
-    }
-    
     std::vector<float> finalVertices;
-    for (int i = 0; i < stacks; ++i) {
-        int k1 = i * (sectors + 1);
-        int k2 = k1 + sectors + 1;
-        
-        for (int j = 0; j < sectors; ++j, ++k1, ++k2) {
-            if (i != 0) {
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + k1 * 6, vertices.begin() + k1 * 6 + 6);
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + k2 * 6, vertices.begin() + k2 * 6 + 6);
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + (k1 + 1) * 6, vertices.begin() + (k1 + 1) * 6 + 6);
-            }
-            
-            if (i != (stacks - 1)) {
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + (k1 + 1) * 6, vertices.begin() + (k1 + 1) * 6 + 6);
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + k2 * 6, vertices.begin() + k2 * 6 + 6);
-                finalVertices.insert(finalVertices.end(), 
-                    vertices.begin() + (k2 + 1) * 6, vertices.begin() + (k2 + 1) * 6 + 6);
-            }
-        }
-    }
+    Geometry::buildSphere(radius, sectors, stacks, finalVertices);
     
     sphereVertexCount = finalVertices.size() / 6;
     
@@ -151,4 +108,58 @@ void Renderer::createSphere(float radius, int sectors, int stacks) {
     glEnableVertexAttribArray(1);
     
     glBindVertexArray(0);
+}
+
+void Renderer::createParticles(size_t maxInstances) {
+    particleCapacity = maxInstances;
+    glGenVertexArrays(1, &particleVAO);
+    glGenBuffers(1, &particleInstanceVBO);
+
+    glBindVertexArray(particleVAO);
+    // Vertices do cubo partilhados com cubeVAO
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, particleInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, maxInstances * sizeof(ParticleInstance), nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, positionSize));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, color));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+}
+
+void Renderer::createImpostors(size_t maxInstances) {
+    float corners[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+
+    glGenVertexArrays(1, &impostorVAO);
+    glGenBuffers(1, &impostorQuadVBO);
+    glGenBuffers(1, &impostorInstanceVBO);
+
+    glBindVertexArray(impostorVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, impostorQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, impostorInstanceVBO);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    reserveImpostors(maxInstances);
+}
+
+void Renderer::reserveImpostors(size_t count) {
+    if (count <= impostorCapacity) return;
+    impostorCapacity = count;
+    glBindBuffer(GL_ARRAY_BUFFER, impostorInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, impostorCapacity * 4 * sizeof(float), nullptr, GL_STREAM_DRAW);
 }
\ No newline at end of file
@@ -1,83 +1,97 @@
 #include "shader.h"
+#include "vfs.h"
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    
-    try {
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        
-        vShaderFile.close();
-        fShaderFile.close();
-        
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
-    }
-    
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    GLuint vertex, fragment;
-    
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-    
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+    build(vertexPath, fragmentPath, nullptr, 0);
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* const* feedbackVaryings, int feedbackCount) {
+    build(vertexPath, fragmentPath, feedbackVaryings, feedbackCount);
+}
+
+void Shader::build(const char* vertexPath, const char* fragmentPath, const char* const* feedbackVaryings, int feedbackCount) {
+    GLuint vertex = compile(vertexPath, GL_VERTEX_SHADER, "VERTEX");
+    GLuint fragment = fragmentPath ? compile(fragmentPath, GL_FRAGMENT_SHADER, "FRAGMENT") : 0;
     
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    if (fragment) glAttachShader(ID, fragment);
+    // Os varyings do transform feedback tem de ser declarados antes do link
+    if (feedbackCount > 0) glTransformFeedbackVaryings(ID, feedbackCount, feedbackVaryings, GL_INTERLEAVED_ATTRIBS);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
     
     glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    if (fragment) glDeleteShader(fragment);
+}
+
+GLuint Shader::compile(const char* path, GLenum type, const char* typeName) {
+    // Fonte lida directamente do Vfs (sem copia quando vem do arquivo mapeado)
+    VfsFile file;
+    if (!Vfs::read(path, file)) {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+    }
+    
+    const char* code = file.data() ? file.data() : "";
+    GLint length = (GLint)file.size();
+    
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &code, &length);
+    glCompileShader(shader);
+    checkCompileErrors(shader, typeName);
+    return shader;
 }
 
 void Shader::use() {
     glUseProgram(ID);
 }
 
+void Shader::setBool(const char* name, bool value) const {
+    glUniform1i(glGetUniformLocation(ID, name), (int)value);
+}
+
+void Shader::setInt(const char* name, int value) const {
+    glUniform1i(glGetUniformLocation(ID, name), value);
+}
+
+void Shader::setFloat(const char* name, float value) const {
+    glUniform1f(glGetUniformLocation(ID, name), value);
+}
+
+void Shader::setVec3(const char* name, const glm::vec3 &value) const {
+    glUniform3fv(glGetUniformLocation(ID, name), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(const char* name, float x, float y, float z) const {
+    glUniform3f(glGetUniformLocation(ID, name), x, y, z);
+}
+
+void Shader::setMat4(const char* name, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
 void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(name.c_str(), value);
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(name.c_str(), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(name.c_str(), value);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    setVec3(name.c_str(), value);
 }
 
 void Shader::setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    setVec3(name.c_str(), x, y, z);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    setMat4(name.c_str(), mat);
 }
 
 void Shader::checkCompileErrors(GLuint shader, std::string type) {
@@ -0,0 +1,103 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<TraceRing>> rings;
+std::atomic<uint32_t> nextTid(1);
+TraceRing* gpuRing = nullptr;
+
+TraceRing* createRing(uint32_t tid, const char* name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    rings.emplace_back(new TraceRing());
+    rings.back()->tid = tid;
+    rings.back()->threadName = name;
+    return rings.back().get();
+}
+
+// O registo so acontece no primeiro evento de cada thread; depois e um acesso thread_local
+TraceRing* threadRing() {
+    thread_local TraceRing* ring = createRing(nextTid++, "thread");
+    return ring;
+}
+
+void copyRing(const TraceRing& ring, uint64_t fromNs, std::vector<TraceEvent>& out) {
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t first = head > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0;
+    for (uint64_t i = first; i < head; i++) {
+        // Se o escritor deu a volta entretanto o slot ja nao e o mesmo evento
+        TraceEvent event;
+        if (!ring.slots[i & (TRACE_RING_CAPACITY - 1)].read(i + 1, event)) continue;
+        if (event.endNs >= fromNs) out.push_back(event);
+    }
+}
+
+} // namespace
+
+bool Trace::enabled = true;
+
+uint64_t Trace::nowNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Trace::setThreadName(const char* name) {
+    threadRing()->threadName = name;
+}
+
+void Trace::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    if (!enabled) return;
+    TraceRing* ring = threadRing();
+    ring->push(TraceEvent{ name, startNs, endNs, ring->tid });
+}
+
+void Trace::recordGpu(const char* name, uint64_t startNs, uint64_t endNs) {
+    if (!enabled) return;
+    // Os resultados GPU so sao lidos pela thread que tem o contexto GL, logo ha um unico escritor
+    if (!gpuRing) gpuRing = createRing(TRACE_GPU_TID, "GPU");
+    gpuRing->push(TraceEvent{ name, startNs, endNs, TRACE_GPU_TID });
+}
+
+bool Trace::dump(const std::string& path, double lastSeconds) {
+    uint64_t now = nowNs();
+    uint64_t window = (uint64_t)(lastSeconds * 1e9);
+    uint64_t fromNs = now > window ? now - window : 0;
+
+    std::vector<TraceEvent> events;
+    std::vector<std::pair<uint32_t, const char*>> threads;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& ring : rings) {
+            copyRing(*ring, fromNs, events);
+            threads.push_back(std::make_pair(ring->tid, ring->threadName.load(std::memory_order_relaxed)));
+        }
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) { std::cerr << "Trace: cannot write " << path << std::endl; return false; }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& thread : threads) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", thread.first, thread.second);
+        first = false;
+    }
+    for (const auto& e : events) {
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",\n", e.name, e.tid == TRACE_GPU_TID ? "gpu" : "cpu", e.tid,
+                     e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0);
+        first = false;
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+    std::cout << "Trace: wrote " << events.size() << " events (" << lastSeconds << " s) to " << path << std::endl;
+    return true;
+}
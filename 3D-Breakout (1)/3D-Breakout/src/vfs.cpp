@@ -0,0 +1,190 @@
+#include "vfs.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef BREAKOUT_USE_LZ4
+#include <lz4.h>
+#endif
+
+namespace {
+
+struct MountedEntry {
+    const char* data;
+    uint64_t storedSize;
+    uint64_t rawSize;
+    uint32_t flags;
+};
+
+struct MappedArchive {
+    const char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+    std::unordered_map<std::string, MountedEntry> entries;
+};
+
+MappedArchive archive;
+
+bool mapFile(const std::string& path) {
+#ifdef _WIN32
+    archive.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (archive.file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(archive.file, &fileSize);
+    archive.size = (size_t)fileSize.QuadPart;
+    archive.mapping = CreateFileMappingA(archive.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!archive.mapping) return false;
+    archive.base = static_cast<const char*>(MapViewOfFile(archive.mapping, FILE_MAP_READ, 0, 0, 0));
+    return archive.base != nullptr;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    // Pede ao kernel uma leitura sequencial de todo o arquivo logo no arranque
+    madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+    madvise(mapped, (size_t)st.st_size, MADV_WILLNEED);
+    archive.base = static_cast<const char*>(mapped);
+    archive.size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+void unmapFile() {
+#ifdef _WIN32
+    if (archive.base) UnmapViewOfFile(archive.base);
+    if (archive.mapping) CloseHandle(archive.mapping);
+    if (archive.file != INVALID_HANDLE_VALUE) CloseHandle(archive.file);
+    archive.mapping = nullptr;
+    archive.file = INVALID_HANDLE_VALUE;
+#else
+    if (archive.base) munmap(const_cast<char*>(archive.base), archive.size);
+#endif
+    archive.base = nullptr;
+    archive.size = 0;
+    archive.entries.clear();
+}
+
+bool readLooseFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!file.good()) return false;
+    std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    out.resize((size_t)size);
+    file.seekg(0, std::ios::beg);
+    return size == 0 || (bool)file.read(out.data(), size);
+}
+
+} // namespace
+
+std::string Vfs::normalize(const std::string& path) {
+    std::string result = path;
+    for (auto& c : result) if (c == '\\') c = '/';
+    while (result.compare(0, 2, "./") == 0) result.erase(0, 2);
+    size_t pos;
+    while ((pos = result.find("/./")) != std::string::npos) result.erase(pos, 2);
+    while ((pos = result.find("//")) != std::string::npos) result.erase(pos, 1);
+    return result;
+}
+
+bool Vfs::mount(const std::string& archivePath) {
+    unmount();
+    if (!mapFile(archivePath)) { unmapFile(); return false; }
+
+    const PakHeader* header = reinterpret_cast<const PakHeader*>(archive.base);
+    if (archive.size < sizeof(PakHeader) || std::memcmp(header->magic, PAK_MAGIC, 4) != 0 || header->version != PAK_VERSION ||
+        header->tocBytes > archive.size - sizeof(PakHeader)) {
+        std::cerr << "VFS: invalid archive " << archivePath << std::endl;
+        unmapFile();
+        return false;
+    }
+
+    const char* cursor = archive.base + sizeof(PakHeader);
+    const char* tocEnd = cursor + header->tocBytes;
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        if ((size_t)(tocEnd - cursor) < sizeof(PakEntry)) break;
+        PakEntry entry;
+        std::memcpy(&entry, cursor, sizeof(PakEntry));
+        cursor += sizeof(PakEntry);
+        // Comparacoes por subtraccao: offset + storedSize pode dar a volta nos 64 bits
+        if (entry.nameLength > (size_t)(tocEnd - cursor) || entry.offset > archive.size || entry.storedSize > archive.size - entry.offset) break;
+        std::string name(cursor, entry.nameLength);
+        cursor += entry.nameLength;
+        archive.entries[name] = MountedEntry{ archive.base + entry.offset, entry.storedSize, entry.rawSize, entry.flags };
+    }
+    std::cout << "VFS: mounted " << archivePath << " (" << archive.entries.size() << " entries, "
+              << archive.size / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+void Vfs::unmount() {
+    if (archive.base) unmapFile();
+}
+
+bool Vfs::isMounted() {
+    return archive.base != nullptr;
+}
+
+bool Vfs::exists(const std::string& path) {
+    std::string key = normalize(path);
+    if (archive.entries.count(key)) return true;
+    return std::ifstream(key.c_str()).good();
+}
+
+bool Vfs::read(const std::string& path, VfsFile& out) {
+    out = VfsFile();
+    std::string key = normalize(path);
+
+    auto it = archive.entries.find(key);
+    if (it != archive.entries.end()) {
+        const MountedEntry& entry = it->second;
+        if (!(entry.flags & PAK_FLAG_LZ4)) {
+            out.ptr = entry.data;
+            out.length = (size_t)entry.rawSize;
+            return true;
+        }
+#ifdef BREAKOUT_USE_LZ4
+        out.owned.resize((size_t)entry.rawSize);
+        int written = LZ4_decompress_safe(entry.data, out.owned.data(), (int)entry.storedSize, (int)entry.rawSize);
+        if (written != (int)entry.rawSize) { std::cerr << "VFS: corrupt LZ4 entry " << key << std::endl; out = VfsFile(); return false; }
+        out.ptr = out.owned.data();
+        out.length = out.owned.size();
+        return true;
+#else
+        std::cerr << "VFS: " << key << " is LZ4 compressed but LZ4 support is not built in" << std::endl;
+        return false;
+#endif
+    }
+
+    if (!readLooseFile(key, out.owned)) return false;
+    out.ptr = out.owned.data();
+    out.length = out.owned.size();
+    return true;
+}
+
+bool Vfs::readText(const std::string& path, std::string& out) {
+    VfsFile file;
+    if (!read(path, file)) return false;
+    out.assign(file.data(), file.size());
+    return true;
+}
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Compara dois relatorios do --bench (bench_report.json) e falha se houver regressao.
+# Uso: bench_compare.py <baseline.json> <atual.json> [--tolerance 0.10]
+import argparse
+import json
+import os
+import sys
+
+METRICS = ("avg", "p99")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two --bench reports")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--tolerance", type=float, default=0.10)
+    args = parser.parse_args()
+    tolerance = args.tolerance
+    baseline_path, current_path = args.baseline, args.current
+    with open(current_path) as f:
+        current = json.load(f)
+    if not os.path.exists(baseline_path):
+        print("No baseline at %s; current run: avg %.3f ms, p99 %.3f ms" %
+              (baseline_path, current["frame_ms"]["avg"], current["frame_ms"]["p99"]))
+        return 0
+    with open(baseline_path) as f:
+        baseline = json.load(f)
+
+    if baseline.get("renderer") != current.get("renderer"):
+        print("Warning: renderer changed (%s -> %s)" % (baseline.get("renderer"), current.get("renderer")))
+
+    failed = False
+    for name in METRICS:
+        old = baseline["frame_ms"][name]
+        new = current["frame_ms"][name]
+        change = (new - old) / old if old > 0 else 0.0
+        status = "REGRESSION" if change > tolerance else "ok"
+        failed = failed or change > tolerance
+        print("%-4s %8.3f ms -> %8.3f ms  (%+.1f%%)  %s" % (name, old, new, change * 100.0, status))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
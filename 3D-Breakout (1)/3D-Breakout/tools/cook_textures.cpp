@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "btex.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "common/stb_image.h"
+
+// Cozinha texturas offline: mipmaps pre-calculados + compressao BC1/BC3 (S3TC)
+// Gera <imagem>.btex ao lado do original, que o Model3D prefere ao carregar
+// Uso: cook_textures [--rgba8] <imagem>...
+
+struct Image {
+    uint32_t width, height;
+    std::vector<uint8_t> rgba;
+};
+
+static Image downsample(const Image& src) {
+    Image dst;
+    dst.width = src.width > 1 ? src.width / 2 : 1;
+    dst.height = src.height > 1 ? src.height / 2 : 1;
+    dst.rgba.resize((size_t)dst.width * dst.height * 4);
+    for (uint32_t y = 0; y < dst.height; y++) {
+        for (uint32_t x = 0; x < dst.width; x++) {
+            uint32_t x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+            uint32_t y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+            for (int c = 0; c < 4; c++) {
+                unsigned sum = src.rgba[((size_t)y0 * src.width + x0) * 4 + c] + src.rgba[((size_t)y0 * src.width + x1) * 4 + c]
+                             + src.rgba[((size_t)y1 * src.width + x0) * 4 + c] + src.rgba[((size_t)y1 * src.width + x1) * 4 + c];
+                dst.rgba[((size_t)y * dst.width + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+static uint16_t pack565(const uint8_t* c) {
+    return (uint16_t)(((c[0] * 31 + 127) / 255) << 11 | ((c[1] * 63 + 127) / 255) << 5 | ((c[2] * 31 + 127) / 255));
+}
+
+static void unpack565(uint16_t c, int* out) {
+    out[0] = ((c >> 11) & 31) * 255 / 31;
+    out[1] = ((c >> 5) & 63) * 255 / 63;
+    out[2] = (c & 31) * 255 / 31;
+}
+
+// Endpoints pela caixa envolvente (com inset) e indices pela cor mais proxima da paleta
+static void encodeColorBlock(const uint8_t block[16][4], uint8_t* out) {
+    uint8_t lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+    for (int p = 0; p < 16; p++) {
+        for (int c = 0; c < 3; c++) { lo[c] = std::min(lo[c], block[p][c]); hi[c] = std::max(hi[c], block[p][c]); }
+    }
+    for (int c = 0; c < 3; c++) {
+        int inset = (hi[c] - lo[c]) / 16;
+        lo[c] = (uint8_t)(lo[c] + inset);
+        hi[c] = (uint8_t)(hi[c] - inset);
+    }
+    uint16_t c0 = pack565(hi), c1 = pack565(lo);
+    if (c0 < c1) std::swap(c0, c1);
+
+    int palette[4][3];
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        for (int p = 0; p < 16; p++) {
+            int best = 0, bestDist = 1 << 30;
+            for (int i = 0; i < 4; i++) {
+                int dr = block[p][0] - palette[i][0], dg = block[p][1] - palette[i][1], db = block[p][2] - palette[i][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) { bestDist = dist; best = i; }
+            }
+            indices |= (uint32_t)best << (2 * p);
+        }
+    }
+    out[0] = (uint8_t)(c0 & 0xFF); out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF); out[3] = (uint8_t)(c1 >> 8);
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(indices >> (8 * i));
+}
+
+static void encodeAlphaBlock(const uint8_t block[16][4], uint8_t* out) {
+    uint8_t a0 = 0, a1 = 255;
+    for (int p = 0; p < 16; p++) { a0 = std::max(a0, block[p][3]); a1 = std::min(a1, block[p][3]); }
+    int levels[8] = { a0, a1 };
+    for (int i = 2; i < 8; i++) levels[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+
+    uint64_t bits = 0;
+    if (a0 != a1) {
+        for (int p = 0; p < 16; p++) {
+            int best = 0, bestDist = 1 << 30;
+            for (int i = 0; i < 8; i++) {
+                int dist = std::abs(block[p][3] - levels[i]);
+                if (dist < bestDist) { bestDist = dist; best = i; }
+            }
+            bits |= (uint64_t)best << (3 * p);
+        }
+    }
+    out[0] = a0;
+    out[1] = a1;
+    for (int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+static std::vector<uint8_t> encodeLevel(const Image& img, uint32_t format) {
+    if (format == BTEX_RGBA8) return img.rgba;
+    std::vector<uint8_t> out(BtexImage::levelSize(format, img.width, img.height));
+    uint8_t* dst = out.data();
+    for (uint32_t by = 0; by < (img.height + 3) / 4; by++) {
+        for (uint32_t bx = 0; bx < (img.width + 3) / 4; bx++) {
+            uint8_t block[16][4];
+            for (int p = 0; p < 16; p++) {
+                uint32_t x = std::min(bx * 4 + (p & 3), img.width - 1), y = std::min(by * 4 + (p >> 2), img.height - 1);
+                std::memcpy(block[p], &img.rgba[((size_t)y * img.width + x) * 4], 4);
+            }
+            if (format == BTEX_BC3) { encodeAlphaBlock(block, dst); dst += 8; }
+            encodeColorBlock(block, dst);
+            dst += 8;
+        }
+    }
+    return out;
+}
+
+static bool cook(const std::string& path, bool forceRgba8) {
+    int width, height, channels;
+    // Mesma orientacao que o Model3D usa ao carregar a imagem original
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!pixels) { std::cerr << path << ": " << stbi_failure_reason() << std::endl; return false; }
+
+    Image level{ (uint32_t)width, (uint32_t)height, std::vector<uint8_t>(pixels, pixels + (size_t)width * height * 4) };
+    stbi_image_free(pixels);
+
+    bool hasAlpha = false;
+    for (size_t i = 3; i < level.rgba.size(); i += 4) if (level.rgba[i] != 255) { hasAlpha = true; break; }
+    uint32_t format = forceRgba8 ? BTEX_RGBA8 : (hasAlpha ? BTEX_BC3 : BTEX_BC1);
+
+    std::vector<Image> chain;
+    chain.push_back(level);
+    while (chain.back().width > 1 || chain.back().height > 1) chain.push_back(downsample(chain.back()));
+
+    BtexHeader header;
+    std::memcpy(header.magic, BTEX_MAGIC, 4);
+    header.format = format;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.levels = (uint32_t)chain.size();
+
+    std::string outPath = path + BTEX_EXTENSION;
+    std::ofstream out(outPath.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t total = 0;
+    for (const auto& mip : chain) {
+        std::vector<uint8_t> data = encodeLevel(mip, format);
+        BtexLevel info{ mip.width, mip.height, (uint32_t)data.size() };
+        out.write(reinterpret_cast<const char*>(&info), sizeof(info));
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+        total += data.size();
+    }
+    static const char* names[] = { "RGBA8", "BC1", "BC3" };
+    std::cout << outPath << ": " << width << "x" << height << " " << names[format] << ", " << chain.size()
+              << " mips, " << total / 1024 << " KB (RGBA8 with mips: " << (size_t)width * height * 4 * 4 / 3 / 1024 << " KB)" << std::endl;
+    return out.good();
+}
+
+int main(int argc, char** argv) {
+    bool forceRgba8 = false;
+    int failures = 0, inputs = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--rgba8") == 0) { forceRgba8 = true; continue; }
+        inputs++;
+        if (!cook(argv[i], forceRgba8)) failures++;
+    }
+    if (inputs == 0) { std::cerr << "usage: cook_textures [--rgba8] <image>..." << std::endl; return 1; }
+    return failures ? 1 : 0;
+}
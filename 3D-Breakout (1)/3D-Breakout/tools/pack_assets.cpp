@@ -0,0 +1,114 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "vfs.h"
+
+#ifdef BREAKOUT_USE_LZ4
+#include <lz4.h>
+#endif
+
+// Junta assets soltos num unico arquivo .pak lido pelo Vfs
+// Uso: pack_assets <saida.pak> [--lz4] <ficheiro|pasta>...
+
+namespace fs = std::filesystem;
+
+struct PackItem {
+    std::string name;
+    std::vector<char> stored;
+    uint64_t rawSize;
+    uint32_t flags;
+};
+
+static bool compressible(const std::string& name) {
+    // Imagens ja comprimidas nao ganham nada com LZ4
+    std::string ext = fs::path(name).extension().string();
+    return ext != ".png" && ext != ".jpg" && ext != ".jpeg";
+}
+
+static void collect(const fs::path& path, std::vector<std::string>& files) {
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(path))
+            if (entry.is_regular_file()) files.push_back(entry.path().generic_string());
+    } else if (fs::is_regular_file(path)) {
+        files.push_back(path.generic_string());
+    } else {
+        std::cerr << "skipping missing " << path << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) { std::cerr << "usage: pack_assets <out.pak> [--lz4] <file|dir>..." << std::endl; return 1; }
+
+    bool useLz4 = false;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--lz4") == 0) useLz4 = true;
+        else collect(argv[i], files);
+    }
+#ifndef BREAKOUT_USE_LZ4
+    if (useLz4) { std::cerr << "built without LZ4, storing uncompressed" << std::endl; useLz4 = false; }
+#endif
+
+    std::vector<PackItem> items;
+    for (const auto& file : files) {
+        std::ifstream in(file.c_str(), std::ios::binary);
+        std::vector<char> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        PackItem item{ Vfs::normalize(file), raw, raw.size(), 0 };
+#ifdef BREAKOUT_USE_LZ4
+        if (useLz4 && compressible(item.name) && !raw.empty()) {
+            std::vector<char> packed(LZ4_compressBound((int)raw.size()));
+            int packedSize = LZ4_compress_default(raw.data(), packed.data(), (int)raw.size(), (int)packed.size());
+            // So compensa se poupar pelo menos 10%
+            if (packedSize > 0 && (size_t)packedSize < raw.size() * 9 / 10) {
+                packed.resize(packedSize);
+                item.stored.swap(packed);
+                item.flags |= PAK_FLAG_LZ4;
+            }
+        }
+#else
+        (void)compressible;
+#endif
+        items.push_back(std::move(item));
+    }
+
+    uint32_t tocBytes = 0;
+    for (const auto& item : items) tocBytes += sizeof(PakEntry) + (uint32_t)item.name.size();
+
+    PakHeader header;
+    std::memcpy(header.magic, PAK_MAGIC, 4);
+    header.version = PAK_VERSION;
+    header.entryCount = (uint32_t)items.size();
+    header.tocBytes = tocBytes;
+
+    uint64_t offset = sizeof(PakHeader) + tocBytes;
+    std::vector<PakEntry> entries;
+    for (const auto& item : items) {
+        offset = (offset + 15) & ~(uint64_t)15;
+        entries.push_back(PakEntry{ offset, item.stored.size(), item.rawSize, item.flags, (uint32_t)item.name.size() });
+        offset += item.stored.size();
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < items.size(); i++) {
+        out.write(reinterpret_cast<const char*>(&entries[i]), sizeof(PakEntry));
+        out.write(items[i].name.data(), items[i].name.size());
+    }
+    uint64_t written = sizeof(PakHeader) + tocBytes;
+    uint64_t rawTotal = 0, storedTotal = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        for (; written < entries[i].offset; written++) out.put('\0');
+        out.write(items[i].stored.data(), items[i].stored.size());
+        written += items[i].stored.size();
+        rawTotal += items[i].rawSize;
+        storedTotal += items[i].stored.size();
+        std::cout << items[i].name << ": " << items[i].rawSize << " -> " << items[i].stored.size()
+                  << ((items[i].flags & PAK_FLAG_LZ4) ? " (lz4)" : "") << std::endl;
+    }
+    std::cout << items.size() << " entries, " << rawTotal / 1024 << " KB -> " << storedTotal / 1024 << " KB" << std::endl;
+    return out.good() ? 0 : 1;
+}